@@ -71,6 +71,16 @@
 
 #define ARP_OPER_REQUEST   1
 #define ARP_OPER_REPLY     2
+
+/* ARP table {{{1 ------------------------------------------------------------*/
+/* How many entries can the ARP table hold, replaced in round robin order.
+ * Entries are learnt from ARP packets and from the source of IPv4 packets for
+ * us, and stamped with SRAM_TIMER1_SECONDS. They are used for ARP_TABLE_TTL
+ * seconds, during the last ARP_TABLE_REFRESH seconds using an entry renews it
+ * with an ARP request to the known MAC address. */
+#define ARP_TABLE_SIZE     6
+#define ARP_TABLE_TTL      600
+#define ARP_TABLE_REFRESH  60
 /* }}}1 */
 
 #endif
@@ -20,4 +20,35 @@
 #define COMM_SRC_PORT 1987
 #define COMM_DST_PORT 1989
 
+/* Batch readings
+ * Keep up to COMM_BATCH_SIZE readings, stamped with SRAM_TIMER1_SECONDS, and
+ * send them in a single datagram once the batch is full or COMM_BATCH_FLUSH
+ * seconds after its first reading, whatever happens first.
+ * Without it, every reading is sent on its own datagram. */
+#define USE_COMM_BATCH     1
+#define COMM_BATCH_SIZE    6
+#define COMM_BATCH_FLUSH   30
+/* First byte of the batched payload, bump it when the format changes */
+#define COMM_BATCH_VERSION 1
+
+/* Multicast
+ * Besides the registered IP addresses, every datagram is sent once to the
+ * multicast group COMM_MCAST_GROUP_0.COMM_MCAST_GROUP_1... on port
+ * COMM_MCAST_PORT, however many listeners there are. Membership is announced
+ * with IGMPv2 (see igmp.S), so that switches with IGMP snooping and routers
+ * forward the group to the listeners.
+ * Use an administratively scoped group (239.0.0.0/8).
+ * Joining the group means we receive what every other publisher sends to it,
+ * so COMM_MCAST_PORT must not be COMM_DST_PORT, where registrations arrive. */
+#define USE_COMM_MCAST     1
+#define COMM_MCAST_GROUP_0 239
+#define COMM_MCAST_GROUP_1 255
+#define COMM_MCAST_GROUP_2 19
+#define COMM_MCAST_GROUP_3 87
+#define COMM_MCAST_PORT    1990
+
+#if USE_COMM_MCAST && COMM_MCAST_PORT == COMM_DST_PORT
+#   error "COMM_MCAST_PORT must differ from COMM_DST_PORT"
+#endif
+
 #endif
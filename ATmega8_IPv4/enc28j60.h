@@ -64,7 +64,7 @@
  * which we don't do at the moment, so ignore it */
 #define USE_LINKIF 0
 
-/* We don't have DMA support at the moment. */
+/* DMA operations are short, we poll for their completion. */
 #define USE_DMAIF  0
 
 /* The Receive Packet Pending Interrupt Flag (PKTIF) is used to indicate the
@@ -76,6 +76,66 @@
 #define USE_INTIE  (USE_RXERIF | USE_TXERIF | USE_TXIF | USE_LINKIF | \
                     USE_DMAIF | USE_PKTIF)
 
+/* Use the DMA checksum engine for TCP replies of at least DMA_CHECKSUM_MIN_LEN
+ * bytes (IPv4 payload), instead of INTERNET_CHECKSUM_RFC1071 on the copy in
+ * SRAM. The reply is written into the transmit buffer with the pseudo header
+ * sum in its checksum field, the DMA sums it there and the result is written
+ * over the checksum field. (ICMP echo replies never go through SRAM, their
+ * checksum is updated, see ICMP_HANDLE_PKT.)
+ *
+ * INTERNET_CHECKSUM_RFC1071 costs 10 cycles per byte. The DMA path costs 10
+ * more control register commands plus a 2 bytes buffer write, whatever the
+ * length, so it only pays off above some length, which depends on the SPI
+ * clock (cycles, independent of F_CPU):
+ *
+ *   SCK       DMA path  break-even  saved on a 255 bytes reply
+ *   F_osc/2      ~ 800    80 bytes    ~ 1750
+ *   F_osc/4     ~ 1150   115 bytes    ~ 1400
+ *   F_osc/8     ~ 1900   190 bytes     ~ 650
+ *   F_osc/16    ~ 3350   335 bytes        -
+ *
+ * DMA_CHECKSUM_MIN_LEN is set for F_osc/2 (SPI_FAST). At F_osc/16 it never
+ * pays off for the segments we send (at most 255 bytes), disable it when
+ * clearing SPI_FAST.
+ *
+ * The silicon errata about DMA operations while receiving is handled by
+ * pausing reception around the DMA, see ETH_DMA_RUN. */
+#define USE_DMA_CHECKSUM     1
+#define DMA_CHECKSUM_MIN_LEN 88
+
+/* A frame is only written into the transmit buffer once the previous one has
+ * left it (ECON1.TXRTS clear), otherwise it is overwritten while on the wire.
+ * Our frames take well under a millisecond at 10 Mb/s. After
+ * ETH_TX_WAIT_POLLS reads of ECON1, about 20 ms at ~75 cycles per read, the
+ * transmit logic is taken as stalled, which the silicon errata describes for
+ * aborted transmissions in half duplex, and reset with ECON1.TXRST; the stuck
+ * frame is lost. See ETH_WAIT_TRANSMIT. */
+#define ETH_TX_WAIT_POLLS    (F_CPU / 3750)
+
+/* Receive filters (ERXFCON), frames with a bad CRC never reach the MCU.
+ * Until we have an IP address, every broadcast is received, DHCP replies may be
+ * broadcast. Once bound, broadcasts go through the pattern match filter, which
+ * only lets ARP requests for our IP address in, see ETH_SET_RECEIVE_FILTER.
+ * Unicast frames for our MAC address are always received, and so are multicast
+ * frames matching the hash table, empty unless ETH_HASH_FILTER_ADD is called. */
+#define ETH_RX_FILTER_UNBOUND (ENC_BANK1_ERXFCON_UCEN | \
+                               ENC_BANK1_ERXFCON_CRCEN | \
+                               ENC_BANK1_ERXFCON_HTEN | \
+                               ENC_BANK1_ERXFCON_BCEN)
+#define ETH_RX_FILTER_BOUND   (ENC_BANK1_ERXFCON_UCEN | \
+                               ENC_BANK1_ERXFCON_CRCEN | \
+                               ENC_BANK1_ERXFCON_HTEN | \
+                               ENC_BANK1_ERXFCON_PMEN)
+/* Pattern match window at offset 0 (EPMO reset value), the mask selects
+ * Type/Len (bytes 12, 13), ARP operation (20, 21) and ARP target IP address
+ * (38 to 41) */
+#define ETH_RX_PATTERN_EPMM1  0x30
+#define ETH_RX_PATTERN_EPMM2  0x30
+#define ETH_RX_PATTERN_EPMM4  0xC0
+#define ETH_RX_PATTERN_EPMM5  0x03
+/* Sum of the constant words of the pattern, 0x0806 (ARP) + 0x0001 (request) */
+#define ETH_RX_PATTERN_SUM    0x0807
+
 /* Addresses in SRAM are 11 bits long, first MSB of the MAC Dst pointer set to
  * one means broadcast */
 #define ENC_MAC_DST_PTR_BROADCAST_BIT        7
@@ -95,12 +155,19 @@
 /* After the transmit buffer, the system writes 7 bytes of status vector */
 #define BUF_RX_ST_L (BUF_TX_ND_L + 0x8)
 #define BUF_RX_ST_H BUF_TX_ND_H
-#define BUF_RX_ND_L 0xFE
+/* ERXND must be odd, ERXRDPT is set to ERXND when the next packet is at ERXST,
+ * see ETH_PKT_PROCESSED */
+#define BUF_RX_ND_L 0xFF
 #define BUF_RX_ND_H 0x1F
 
 #define BUF_RX_SIZE (((BUF_RX_ND_H << 8) + BUF_RX_ND_L) - \
                      ((BUF_RX_ST_H << 8) + BUF_RX_ST_L) + 1)
 
+/* Ethernet payload in the transmit buffer, after the per packet control byte
+ * and the Ethernet header (Dst/Src MAC addresses + Type/Len). */
+#define BUF_TX_PAYLOAD_L (BUF_TX_ST_L + 1 + 6 + 6 + 2)
+#define BUF_TX_PAYLOAD_H BUF_TX_ST_H
+
 /* Common set of registers {{{1  ---------------------------------------------*/
 /* INTIE PKTIE DMAIE LINKIE TXIE r TXERIE RXERIE 0000 0000 */
 #define ENC_COMMON_EIE         0x1B
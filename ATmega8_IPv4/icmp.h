@@ -44,4 +44,14 @@
 #define ICMP_MSG_TYPE_INFORMATION_REQUEST      15
 #define ICMP_MSG_TYPE_INFORMATION_REPLY        16
 
+/* Destination Unreachable Message codes -------------------------------------*/
+#define ICMP_CODE_NET_UNREACHABLE               0
+#define ICMP_CODE_HOST_UNREACHABLE              1
+#define ICMP_CODE_PROTOCOL_UNREACHABLE          2
+#define ICMP_CODE_PORT_UNREACHABLE              3
+
+/* Destination Unreachable Message quotes the internet header and the first 64
+ * bits of the original datagram */
+#define ICMP_QUOTED_DATAGRAM_LEN                8
+
 #endif
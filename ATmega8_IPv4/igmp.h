@@ -0,0 +1,55 @@
+/* LICENSE {{{ -----------------------------------------------------------------
+ * IPv4 stack for AVR (ATmega8) microcontroller.
+ * Copyright (C) 2020 Fabrizio Cabaleiro
+ * 
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 2.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ * ------------------------------------------------------------------------}}}*/
+#ifndef _IGMP_H_
+#define _IGMP_H_
+
+/* https://tools.ietf.org/html/rfc2236 -----------------------------------------
+ *
+ * IGMPv2 message:
+ *
+ *    0               1               2               3
+ *    0 1 2 3 4 5 6 7 0 1 2 3 4 5 6 7 0 1 2 3 4 5 6 7 0 1 2 3 4 5 6 7
+ *   +---------------+---------------+-------------------------------+
+ * 0 |     Type      | Max Resp Time |           Checksum            |
+ *   +---------------+---------------+-------------------------------+
+ * 4 |                         Group Address                         |
+ *   +---------------------------------------------------------------+
+ *
+ * Sent with TTL 1 and the IP Router Alert option (RFC 2113).
+ * ---------------------------------------------------------------------------*/
+#define IGMP_TYPE                     0
+#define IGMP_MAX_RESP_TIME            1
+#define IGMP_CHECKSUM                 2
+#define IGMP_GROUP_ADDR               4
+#define IGMP_MSG_LEN                  8
+
+/* Message Types -------------------------------------------------------------*/
+#define IGMP_MSG_TYPE_MEMBERSHIP_QUERY     0x11
+#define IGMP_MSG_TYPE_V1_MEMBERSHIP_REPORT 0x12
+#define IGMP_MSG_TYPE_V2_MEMBERSHIP_REPORT 0x16
+#define IGMP_MSG_TYPE_LEAVE_GROUP          0x17
+
+/* IPv4 header with Router Alert option */
+#define IGMP_IPV4_HEADER_LEN          24
+#define IGMP_IPV4_OPTION_ROUTER_ALERT 0x94
+
+/* Seconds between unsolicited membership reports, well below the Group
+ * Membership Interval of the routers (260 seconds by default). Queries are
+ * answered after 1 to 8 seconds. */
+#define IGMP_REPORT_INTERVAL          60
+
+#endif
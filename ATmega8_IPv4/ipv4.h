@@ -23,7 +23,9 @@
 #define IPV4_ADDR_LEN                    4
 #define IPV4_PORT_LEN                    2
 #define IPV4_DEFAULT_HEADER_LEN         20
-#define IPV4_PAYLOAD_LEN               200
+/* Outgoing IPv4 payload built in SRAM, only the UDP datagrams of comm.S, ICMP
+ * echo replies are built inside the ENC28J60 */
+#define IPV4_PAYLOAD_LEN                16
 
 /* Data offset with respect to SRAM_IPV4, this macros can be generated by:
  * avr-nm --no-sort Objs/ipv4.o |grep SRAM_ | sort | awk '$2 ~ "[dD]"{ sub("SRAM_", "", $3); printf "#define %-30s %s\n", $3, "0x"$1 }'
@@ -96,6 +98,8 @@
 // #define INTERNET_PROTOCOL_NUMBER_RESERVED 0
 #define INTERNET_PROTOCOL_NUMBER_ICMP                               1
 // #define INTERNET_PROTOCOL_NUMBER_UNASSIGNED 2
+/* Assigned later to IGMP, RFC 1112 */
+#define INTERNET_PROTOCOL_NUMBER_IGMP                               2
 #define INTERNET_PROTOCOL_NUMBER_GATEWAY_TO_GATEWAY                 3
 #define INTERNET_PROTOCOL_NUMBER_CMCC_GATEWAY_MONITORING_MESSAGE    4
 #define INTERNET_PROTOCOL_NUMBER_ST                                 5
@@ -30,6 +30,11 @@
 |   1   |   1  |   1  |  f osc / 64    |
 +-------+------+------+---------------*/
 
+/* SCK to F_osc/2 (SPI2X), otherwise F_osc/16.
+ * With SPI_FAST, MEMCPY_SPI_SRAM and MEMCPY_SRAM_SPI use SPI_BURST_READ and
+ * SPI_BURST_WRITE, which don't poll SPIF and only work at F_osc/2. */
+#define SPI_FAST 1
+
 #define SPI_SS_DDR    DDRB
 #define SPI_MOSI_BIT  PB3
 #define SPI_MOSI_DDR  DDRB
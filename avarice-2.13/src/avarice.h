@@ -42,4 +42,7 @@ void vstatusOut(const char *fmt, va_list args);
 void statusOut(const char *fmt, ...);
 void statusFlush();
 
+/** Current time in microseconds, for timing measurements **/
+unsigned long long getTimeUsec(void);
+
 #endif // INCLUDE_AVARICE_H
@@ -0,0 +1,456 @@
+/*
+ *	avarice - The "avarice" program.
+ *
+ *	This program is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License Version 2
+ *	as published by the Free Software Foundation.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111, USA.
+ *
+ * This file implements running scripted steps (program, run to a
+ * breakpoint, read results...) directly on theJtagICE, for automated
+ * tests that do not need an interactive debugger.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "avarice.h"
+#include "jtag.h"
+#include "symbols.h"
+#include "latency.h"
+#include "hexcodec.h"
+#include "console.h"
+#include "batch.h"
+
+enum
+{
+    // Longest script line, and most arguments per step.
+    BATCH_MAX_LINE	= 1024,
+    BATCH_MAX_ARGS	= 8,
+};
+
+struct batch_op
+{
+    const char *name;
+    bool (*func)(int argc, char **argv);
+    const char *usage;
+};
+
+static FILE *batchOut;
+// Set by a failing step, unless it threw a jtag_exception.
+static const char *batchError;
+
+static const char WRONG_ARGS[] = "wrong number of arguments";
+
+static bool opErase(int argc, char **argv);
+static bool opProgram(int argc, char **argv);
+static bool opVerify(int argc, char **argv);
+static bool opReset(int argc, char **argv);
+static bool opBreak(int argc, char **argv);
+static bool opDelete(int argc, char **argv);
+static bool opContinue(int argc, char **argv);
+static bool opRead(int argc, char **argv);
+static bool opWrite(int argc, char **argv);
+static bool opDump(int argc, char **argv);
+
+static const batch_op batchOps[] =
+{
+    { "erase",		opErase,	"erase" },
+    { "program",	opProgram,	"program <file>" },
+    { "verify",		opVerify,	"verify <file>" },
+    { "reset",		opReset,	"reset" },
+    { "break",		opBreak,	"break <location>" },
+    { "delete",		opDelete,	"delete <location>" },
+    { "continue",	opContinue,	"continue [<seconds>]" },
+    { "read",		opRead,		"read <var>[:<size>]" },
+    { "write",		opWrite,	"write <var>[:<size>] <hex bytes>" },
+    { "dump",		opDump,		"dump <var>[:<size>] <file>" },
+    { 0, 0, 0 }
+};
+
+/** Add ',"<name>":<value>' to the current result line. **/
+static void field(const char *name, const char *fmt, ...)
+{
+    va_list args;
+
+    fprintf(batchOut, ",\"%s\":", name);
+    va_start(args, fmt);
+    vfprintf(batchOut, fmt, args);
+    va_end(args);
+}
+
+/** Add a string field, escaped for JSON. **/
+static void stringField(const char *name, const char *s)
+{
+    fprintf(batchOut, ",\"%s\":\"", name);
+    for (; *s != '\0'; s++)
+    {
+	unsigned char c = *s;
+
+	if (c == '"' || c == '\\')
+	    fprintf(batchOut, "\\%c", c);
+	else if (c < ' ')
+	    fprintf(batchOut, "\\u%04x", c);
+	else
+	    putc(c, batchOut);
+    }
+    putc('"', batchOut);
+}
+
+static bool fail(const char *msg)
+{
+    batchError = msg;
+    return false;
+}
+
+static bool opErase(int argc, char **)
+{
+    if (argc != 1)
+	return fail(WRONG_ARGS);
+
+    theJtagICE->enableProgramming();
+    theJtagICE->eraseProgramMemory();
+    theJtagICE->disableProgramming();
+    return true;
+}
+
+static bool opProgram(int argc, char **argv)
+{
+    if (argc != 2)
+	return fail(WRONG_ARGS);
+
+    // As --program does.
+    theJtagICE->downloadToTarget(argv[1], true, false);
+    theJtagICE->resetProgram(false);
+    return true;
+}
+
+static bool opVerify(int argc, char **argv)
+{
+    if (argc != 2)
+	return fail(WRONG_ARGS);
+
+    theJtagICE->downloadToTarget(argv[1], false, true);
+    return true;
+}
+
+static bool opReset(int argc, char **)
+{
+    if (argc != 1)
+	return fail(WRONG_ARGS);
+
+    theJtagICE->resetProgram(false);
+    return true;
+}
+
+static bool opBreak(int argc, char **argv)
+{
+    unsigned long addr;
+
+    if (argc != 2)
+	return fail(WRONG_ARGS);
+    if (!parseCodeAddress(argv[1], addr))
+	return fail("cannot resolve location");
+
+    field("address", "%lu", addr);
+    if (!theJtagICE->addBreakpoint(addr, CODE, 0))
+	return fail("no breakpoint available");
+    return true;
+}
+
+static bool opDelete(int argc, char **argv)
+{
+    unsigned long addr;
+
+    if (argc != 2)
+	return fail(WRONG_ARGS);
+    if (!parseCodeAddress(argv[1], addr))
+	return fail("cannot resolve location");
+
+    field("address", "%lu", addr);
+    if (!theJtagICE->deleteBreakpoint(addr, CODE, 0))
+	return fail("no breakpoint at this location");
+    return true;
+}
+
+static bool opContinue(int argc, char **argv)
+{
+    double seconds = 0;
+
+    if (argc > 2)
+	return fail(WRONG_ARGS);
+    if (argc == 2 && (seconds = atof(argv[1])) <= 0)
+	return fail("invalid timeout");
+
+    // Step off the breakpoint we are sitting at, as GDB would.
+    unsigned long pc = theJtagICE->getProgramCounter();
+    if (theJtagICE->codeBreakpointAt(pc))
+	theJtagICE->jtagSingleStep();
+
+    theJtagICE->continueTimeout = (unsigned long long)(seconds * 1e6);
+    bool hit;
+    try
+    {
+	hit = theJtagICE->jtagContinue();
+    }
+    catch (jtag_exception&)
+    {
+	theJtagICE->continueTimeout = 0;
+	throw;
+    }
+    theJtagICE->continueTimeout = 0;
+
+    if (!hit)
+	theJtagICE->interruptProgram();
+    consoleDrain();
+
+    unsigned long offset;
+    pc = theJtagICE->getProgramCounter();
+    const char *sym = symbolAt(pc, offset);
+
+    field("pc", "%lu", pc);
+    if (sym != NULL)
+    {
+	stringField("symbol", sym);
+	field("offset", "%lu", offset);
+    }
+    if (!hit)
+	return fail("timed out");
+    return true;
+}
+
+/** Read the memory described by 'spec'.  Returns NULL on failure. **/
+static uchar *readVar(const char *spec, unsigned long &addr,
+		      unsigned int &size)
+{
+    if (!parseSymbolSpec(spec, addr, size))
+    {
+	fail("cannot resolve variable");
+	return NULL;
+    }
+    if (size == 0)
+    {
+	fail("variable has no size");
+	return NULL;
+    }
+    field("address", "%lu", addr);
+    field("size", "%u", size);
+
+    uchar *mem = theJtagICE->jtagRead(addr, size);
+    if (mem == NULL)
+	fail("reading target memory failed");
+    return mem;
+}
+
+static bool opRead(int argc, char **argv)
+{
+    unsigned long addr;
+    unsigned int size;
+
+    if (argc != 2)
+	return fail(WRONG_ARGS);
+
+    uchar *mem = readVar(argv[1], addr, size);
+    if (mem == NULL)
+	return false;
+
+    char *hex = new char[2 * size + 1];
+    hexEncode(mem, size, hex);
+    hex[2 * size] = '\0';
+    field("data", "\"%s\"", hex);
+    delete [] hex;
+    delete [] mem;
+    return true;
+}
+
+static bool opWrite(int argc, char **argv)
+{
+    unsigned long addr;
+    unsigned int size;
+
+    if (argc != 3)
+	return fail(WRONG_ARGS);
+    if (!parseSymbolSpec(argv[1], addr, size))
+	return fail("cannot resolve variable");
+
+    size_t len = strlen(argv[2]);
+    if (size == 0)
+	size = len / 2;
+    if (len != 2 * size)
+	return fail("data does not match variable size");
+    field("address", "%lu", addr);
+    field("size", "%u", size);
+
+    uchar *data = new uchar[size];
+    if (!hexDecode(argv[2], size, data))
+    {
+	delete [] data;
+	return fail("invalid hex data");
+    }
+    try
+    {
+	theJtagICE->jtagWrite(addr, size, data);
+    }
+    catch (jtag_exception&)
+    {
+	delete [] data;
+	throw;
+    }
+    delete [] data;
+    return true;
+}
+
+static bool opDump(int argc, char **argv)
+{
+    unsigned long addr;
+    unsigned int size;
+
+    if (argc != 3)
+	return fail(WRONG_ARGS);
+
+    uchar *mem = readVar(argv[1], addr, size);
+    if (mem == NULL)
+	return false;
+
+    FILE *f = fopen(argv[2], "wb");
+    bool ok = f != NULL && fwrite(mem, 1, size, f) == size;
+    if (f != NULL && fclose(f) != 0)
+	ok = false;
+    delete [] mem;
+
+    if (!ok)
+	return fail("cannot write file");
+    return true;
+}
+
+/** Split 'line' into at most BATCH_MAX_ARGS words, dropping comments.
+    Returns the number of words.
+**/
+static int tokenize(char *line, char **argv)
+{
+    int argc = 0;
+    char *p = line;
+
+    for (;;)
+    {
+	while (isspace((unsigned char)*p))
+	    p++;
+	if (*p == '\0' || *p == '#')
+	    return argc;
+	if (argc == BATCH_MAX_ARGS)
+	    return -1;
+	argv[argc++] = p;
+	while (*p != '\0' && !isspace((unsigned char)*p))
+	    p++;
+	if (*p != '\0')
+	    *p++ = '\0';
+    }
+}
+
+bool batchRun(const char *filename, const char *output)
+{
+    FILE *in = strcmp(filename, "-") == 0? stdin: fopen(filename, "r");
+    char line[BATCH_MAX_LINE];
+    unsigned int lineno = 0, step = 0;
+    bool ok = true;
+
+    if (in == NULL)
+    {
+	fprintf(stderr, "Cannot open batch script %s\n", filename);
+	return false;
+    }
+    batchOut = output == NULL? stdout: fopen(output, "w");
+    if (batchOut == NULL)
+    {
+	fprintf(stderr, "Cannot open batch output %s\n", output);
+	if (in != stdin)
+	    fclose(in);
+	return false;
+    }
+
+    unsigned long long start = getTimeUsec();
+
+    while (ok && fgets(line, sizeof line, in) != NULL)
+    {
+	char *argv[BATCH_MAX_ARGS];
+	int argc;
+
+	lineno++;
+	argc = tokenize(line, argv);
+	if (argc == 0)
+	    continue;
+
+	step++;
+	fprintf(batchOut, "{\"step\":%u,\"line\":%u", step, lineno);
+	if (argc > 0)
+	    stringField("op", argv[0]);
+
+	const batch_op *op = NULL;
+	if (argc < 0)
+	    batchError = "too many arguments";
+	else
+	{
+	    for (op = batchOps; op->name != NULL; op++)
+		if (strcmp(op->name, argv[0]) == 0)
+		    break;
+	    if (op->name == NULL)
+	    {
+		op = NULL;
+		batchError = "unknown step";
+	    }
+	}
+
+	unsigned long long t0 = getTimeUsec();
+	if (op == NULL)
+	    ok = false;
+	else
+	{
+	    batchError = NULL;
+	    try
+	    {
+		ok = op->func(argc, argv);
+	    }
+	    catch (jtag_exception& e)
+	    {
+		batchError = e.what();
+		ok = false;
+	    }
+	}
+	unsigned long long t1 = getTimeUsec();
+
+	field("ok", "%s", ok? "true": "false");
+	if (!ok)
+	{
+	    stringField("error", batchError != NULL? batchError: "failed");
+	    if (batchError == WRONG_ARGS)
+		stringField("usage", op->usage);
+	}
+	field("usec", "%llu", t1 - t0);
+	fprintf(batchOut, "}\n");
+	fflush(batchOut);
+    }
+
+    fprintf(batchOut, "{\"summary\":true,\"steps\":%u,\"ok\":%s,"
+	    "\"usec\":%llu}\n", step, ok? "true": "false",
+	    getTimeUsec() - start);
+
+    if (in != stdin)
+	fclose(in);
+    if (batchOut != stdout)
+	fclose(batchOut);
+    else
+	fflush(batchOut);
+
+    return ok;
+}
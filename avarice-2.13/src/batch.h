@@ -0,0 +1,56 @@
+/*
+ *	avarice - The "avarice" program.
+ *
+ *	This program is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License Version 2
+ *	as published by the Free Software Foundation.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111, USA.
+ *
+ * Interface definition for the batch script interpreter (batch.cc).
+ *
+ * A script has one step per line; empty lines and anything after a
+ * '#' are ignored.  Steps:
+ *
+ *   erase
+ *   program <file>		as --program, including the reset
+ *   verify <file>
+ *   reset
+ *   break <location>		code symbol or byte address
+ *   delete <location>
+ *   continue [<seconds>]	fails if no breakpoint is hit in time
+ *   read <var>[:<size>]
+ *   write <var>[:<size>] <hex bytes>
+ *   dump <var>[:<size>] <file>
+ *
+ * Variables are as for --sample: symbols from the --symbols file, or
+ * numeric addresses (with DATA_SPACE_ADDR_OFFSET etc.) and a size.
+ *
+ * Each step produces one line of JSON, e.g.
+ *
+ *   {"step":3,"line":7,"op":"read","address":8388864,"size":2,
+ *    "data":"2a00","ok":true,"usec":1893}
+ *
+ * followed by a final {"summary":true,...} line.  The script stops at
+ * the first failing step.
+ */
+
+#ifndef INCLUDE_BATCH_H
+#define INCLUDE_BATCH_H
+
+/** Run the steps in script 'filename' ("-" for stdin) on the stopped
+    target, writing the results to 'output' (stdout if NULL).  The
+    target is left stopped.
+
+    Returns false if the script could not be read, or a step failed.
+**/
+bool batchRun(const char *filename, const char *output);
+
+#endif /* INCLUDE_BATCH_H */
@@ -0,0 +1,1165 @@
+/*
+ *	avarice - The "avarice" program.
+ *
+ *	This program is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License Version 2
+ *	as published by the Free Software Foundation.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111, USA.
+ *
+ * This file implements avarice-bench, a set of micro benchmarks for
+ * the host side code paths that matter for large transfers and for
+ * stepping.  It is linked against the same objects as avarice itself,
+ * and drives them without a JTAG ICE or GDB: protocol streams are
+ * routed through socket pairs instead.
+ *
+ * It is not built by default; use "make avarice-bench", or "make
+ * bench" to run all benchmarks and record the results in bench.json.
+ *
+ * Usage: avarice-bench [--json] [benchmark...]
+ *
+ * With --json, the results are written to stdout as a JSON object
+ * with one entry per measurement, suitable for comparing releases.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+
+#include "avarice.h"
+#include "console.h"
+#include "crc16.h"
+#include "hexcodec.h"
+#include "jtag1.h"
+#include "jtag2.h"
+#include "remote.h"
+
+extern "C" const unsigned short crc_table[256];
+
+// Normally defined in main.cc.
+jtag *theJtagICE;
+bool ignoreInterrupts;
+
+enum
+{
+    // Each measurement runs for at least this long.
+    MIN_BENCH_USEC	= 100000,
+
+    MAX_COLUMNS		= 8,
+};
+
+static bool jsonOutput;
+static unsigned int numResults;
+
+// The table currently being filled in.
+static const char *tableName;
+static const char *tableUnit;
+
+static unsigned long long benchTime(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return (unsigned long long)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+/** Call 'op' repeatedly for at least MIN_BENCH_USEC, and return the
+    number of calls per second.
+**/
+static double callRate(void (*op)(void))
+{
+    unsigned long long t0 = benchTime(), t, n;
+
+    for (n = 0; (t = benchTime() - t0) < MIN_BENCH_USEC; n++)
+	op();
+    return n * 1e6 / t;
+}
+
+static void fillRandom(uchar *buf, unsigned int len)
+{
+    for (unsigned int i = 0; i < len; i++)
+	buf[i] = rand() >> 7;
+}
+
+static void fail(const char *what)
+{
+    fprintf(stderr, "avarice-bench: %s\n", what);
+    exit(1);
+}
+
+/*
+ * Results.
+ *
+ * Each benchmark produces a table: one row per size (whatever that
+ * means for the benchmark), one column per variant.  In JSON mode,
+ * every cell becomes one entry of the "results" array instead.
+ */
+
+static void beginTable(const char *name, const char *unit,
+		       const char *title, const char *const columns[])
+{
+    tableName = name;
+    tableUnit = unit;
+    if (jsonOutput)
+	return;
+
+    printf("\n%s (%s)\n%-10s", title, unit, "size");
+    for (int i = 0; columns[i] != NULL; i++)
+	printf(" %10s", columns[i]);
+    printf("\n");
+}
+
+static void beginRow(unsigned int size)
+{
+    if (!jsonOutput)
+	printf("%-10u", size);
+}
+
+static void result(const char *variant, unsigned int size, double value)
+{
+    if (jsonOutput)
+	printf("%s\n    { \"benchmark\": \"%s\", \"variant\": \"%s\", "
+	       "\"size\": %u, \"value\": %.2f, \"unit\": \"%s\" }",
+	       numResults++ == 0? "": ",", tableName, variant, size,
+	       value, tableUnit);
+    else
+	printf(" %10.1f", value);
+}
+
+static void endRow(void)
+{
+    if (!jsonOutput)
+	printf("\n");
+}
+
+/** Connect 'fds' to the two ends of a local stream socket, with
+    buffers large enough to hold any frame we send through them.
+**/
+static void makeSocketPair(int fds[2])
+{
+    int bufsize = 256 * 1024;
+
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0)
+	fail("cannot create socket pair");
+    for (int i = 0; i < 2; i++)
+    {
+	setsockopt(fds[i], SOL_SOCKET, SO_SNDBUF, &bufsize, sizeof bufsize);
+	setsockopt(fds[i], SOL_SOCKET, SO_RCVBUF, &bufsize, sizeof bufsize);
+    }
+}
+
+static void readFully(int fd, void *buf, unsigned int len)
+{
+    uchar *cp = (uchar *)buf;
+
+    while (len > 0)
+    {
+	ssize_t n = read(fd, cp, len);
+
+	if (n <= 0)
+	    fail("short read from socket pair");
+	cp += n;
+	len -= n;
+    }
+}
+
+static void writeFully(int fd, const void *buf, unsigned int len)
+{
+    if (write(fd, buf, len) != (ssize_t)len)
+	fail("short write to socket pair");
+}
+
+/*
+ * Hex encoding/decoding.
+ *
+ * The reference versions are the nibble-at-a-time routines remote.cc
+ * used before hexcodec.cc existed.
+ */
+
+static const unsigned char refHexchars[] = "0123456789abcdef";
+
+static int refHex(unsigned char ch)
+{
+    if ((ch >= 'a') && (ch <= 'f'))
+	return (ch - 'a' + 10);
+    if ((ch >= '0') && (ch <= '9'))
+	return (ch - '0');
+    if ((ch >= 'A') && (ch <= 'F'))
+	return (ch - 'A' + 10);
+    return (-1);
+}
+
+static void refEncode(const uchar *src, unsigned int len, char *dst)
+{
+    for (unsigned int i = 0; i < len; i++)
+    {
+	*dst++ = refHexchars[src[i] >> 4];
+	*dst++ = refHexchars[src[i] & 0xf];
+    }
+}
+
+static bool refDecode(const char *src, unsigned int len, uchar *dst)
+{
+    for (unsigned int i = 0; i < len; i++)
+    {
+	unsigned char ch = refHex(*src++) << 4;
+	*dst++ = ch + refHex(*src++);
+    }
+    return true;
+}
+
+static bool refAvailable(void)
+{
+    return true;
+}
+
+static const hex_codec refCodec =
+{
+    "reference", refAvailable, refEncode, refDecode
+};
+
+static bool checkHexCodec(const hex_codec *hc)
+{
+    enum { LEN = 1000 };
+    uchar src[LEN], dst[LEN];
+    char enc[2 * LEN], ref[2 * LEN];
+
+    fillRandom(src, LEN);
+    for (unsigned int len = 0; len <= LEN; len += len < 100? 1: 99)
+    {
+	hc->encode(src, len, enc);
+	refEncode(src, len, ref);
+	if (memcmp(enc, ref, 2 * len) != 0)
+	    return false;
+
+	for (unsigned int i = 0; i < 2 * len; i += 3)
+	    if (enc[i] >= 'a')
+		enc[i] -= 'a' - 'A';
+	if (!hc->decode(enc, len, dst) || memcmp(dst, src, len) != 0)
+	    return false;
+
+	// Every position must catch a bad digit.
+	for (unsigned int i = 0; i < 2 * len; i += len < 64? 1: 7)
+	{
+	    static const char bad[] = { 'g', 'G', '/', ':', '@', '`',
+					' ', '\0', '\x80', '\xb0', '\xe1' };
+	    char save = enc[i];
+
+	    enc[i] = bad[i % sizeof bad];
+	    bool ok = hc->decode(enc, len, dst);
+	    enc[i] = save;
+	    if (ok)
+		return false;
+	}
+    }
+    return true;
+}
+
+static const hex_codec *hexCodec;
+static uchar *hexBin;
+static char *hexText;
+static unsigned int hexLen;
+
+static void opHexEncode(void)
+{
+    hexCodec->encode(hexBin, hexLen, hexText);
+}
+
+static void opHexDecode(void)
+{
+    hexCodec->decode(hexText, hexLen, hexBin);
+}
+
+static void benchHex(void)
+{
+    enum { MAXLEN = 64 * 1024 };
+    const hex_codec *codecs[MAX_COLUMNS];
+    const char *columns[MAX_COLUMNS + 1];
+    int n = 0;
+
+    codecs[n++] = &refCodec;
+    for (const hex_codec *hc = hexCodecs; hc->name != NULL; hc++)
+    {
+	if (!hc->available() || n == MAX_COLUMNS)
+	    continue;
+	if (!checkHexCodec(hc))
+	    fail("hex codec failed the conformance check");
+	codecs[n++] = hc;
+    }
+    for (int k = 0; k < n; k++)
+	columns[k] = codecs[k]->name;
+    columns[n] = NULL;
+
+    hexBin = new uchar[MAXLEN];
+    hexText = new char[2 * MAXLEN];
+    fillRandom(hexBin, MAXLEN);
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+	if (pass == 0)
+	    beginTable("hex-encode", "MB/s", "hex encoding, binary side",
+		       columns);
+	else
+	    beginTable("hex-decode", "MB/s", "hex decoding, binary side",
+		       columns);
+	for (hexLen = 1024; hexLen <= MAXLEN; hexLen *= 4)
+	{
+	    beginRow(hexLen);
+	    for (int k = 0; k < n; k++)
+	    {
+		hexCodec = codecs[k];
+		// Decoding needs valid input.
+		hexCodec->encode(hexBin, hexLen, hexText);
+		double rate = callRate(pass == 0? opHexEncode: opHexDecode);
+		result(hexCodec->name, hexLen, rate * hexLen / 1e6);
+	    }
+	    endRow();
+	}
+    }
+
+    delete [] hexBin;
+    delete [] hexText;
+}
+
+/*
+ * CRC-16 of JTAG ICE mkII frames.
+ *
+ * The reference version is the byte-at-a-time loop crc16.c used before
+ * it switched to slicing-by-8.
+ */
+
+static unsigned short refCrcsum(const uchar *message, unsigned long length,
+				unsigned short crc)
+{
+    for (unsigned long i = 0; i < length; i++)
+	crc = (crc >> 8) ^ crc_table[(crc ^ message[i]) & 0xff];
+    return crc;
+}
+
+static bool checkCrc(void)
+{
+    enum { LEN = 1000 };
+    uchar msg[LEN + 2];
+
+    fillRandom(msg, LEN);
+    for (unsigned int len = 0; len <= LEN; len += len < 100? 1: 37)
+    {
+	unsigned short crc = refCrcsum(msg, len, CRC_INIT);
+
+	if (crcsum(msg, len, CRC_INIT) != crc)
+	    return false;
+	// Piecewise computation must give the same result, whatever
+	// the alignment of the pieces.
+	for (unsigned int split = 0; split <= len; split += 1 + len / 8)
+	    if (crcsum(msg + split, len - split,
+		       crcsum(msg, split, CRC_INIT)) != crc)
+		return false;
+
+	crcappend(msg, len);
+	if (!crcverify(msg, len + 2) || !crccheck(msg + len, crc))
+	    return false;
+	msg[len / 2] ^= 0x10;
+	if (crcverify(msg, len + 2))
+	    return false;
+	msg[len / 2] ^= 0x10;
+    }
+    return true;
+}
+
+static uchar *crcMsg;
+static unsigned int crcLen;
+static volatile unsigned short crcSink;
+
+static void opRefCrc(void)
+{
+    crcSink = refCrcsum(crcMsg, crcLen, CRC_INIT);
+}
+
+static void opCrc(void)
+{
+    crcSink = crcsum(crcMsg, crcLen, CRC_INIT);
+}
+
+static void benchCrc(void)
+{
+    enum { MAXLEN = 64 * 1024 };
+    static const char *const columns[] = { "reference", "crcsum", NULL };
+
+    if (!checkCrc())
+	fail("crcsum failed the conformance check");
+
+    crcMsg = new uchar[MAXLEN];
+    fillRandom(crcMsg, MAXLEN);
+
+    beginTable("crc16", "MB/s", "CRC-16 of mkII frames", columns);
+    for (crcLen = 16; crcLen <= MAXLEN; crcLen *= 4)
+    {
+	beginRow(crcLen);
+	result("reference", crcLen, callRate(opRefCrc) * crcLen / 1e6);
+	result("crcsum", crcLen, callRate(opCrc) * crcLen / 1e6);
+	endRow();
+    }
+
+    delete [] crcMsg;
+}
+
+/*
+ * GDB remote protocol packets.
+ *
+ * getpacket() and putpacket() talk to one end of a socket pair; the
+ * benchmark plays GDB on the other end.
+ */
+
+static int rspPeer;
+static char rspPacket[BUFMAX + 8];
+static unsigned int rspPacketLen;
+static char *rspPayload;
+
+static void opGetpacket(void)
+{
+    char ack;
+
+    writeFully(rspPeer, rspPacket, rspPacketLen);
+    getpacket();
+    readFully(rspPeer, &ack, 1);
+}
+
+static void opPutpacket(void)
+{
+    char ack = '+';
+
+    writeFully(rspPeer, &ack, 1);
+    putpacket(rspPayload);
+    readFully(rspPeer, rspPacket, rspPacketLen);
+}
+
+static void benchRsp(void)
+{
+    static const char *const columns[] = { "getpacket", "putpacket", NULL };
+    int fds[2];
+
+    makeSocketPair(fds);
+    setGdbFile(fds[0]);
+    rspPeer = fds[1];
+    rspPayload = new char[BUFMAX];
+
+    beginTable("rsp-packet", "us", "GDB packet round trip", columns);
+    for (unsigned int len = 16; len < BUFMAX; len *= 2)
+    {
+	unsigned char csum = 0;
+
+	// A memory write, the typical large packet.
+	snprintf(rspPayload, BUFMAX, "M800100,%x:", (len - 12) / 2);
+	for (unsigned int i = strlen(rspPayload); i < len; i++)
+	    rspPayload[i] = refHexchars[rand() & 15];
+	rspPayload[len] = '\0';
+	for (unsigned int i = 0; i < len; i++)
+	    csum += rspPayload[i];
+	rspPacketLen = sprintf(rspPacket, "$%s#%02x", rspPayload, csum);
+
+	writeFully(rspPeer, rspPacket, rspPacketLen);
+	if (strcmp(getpacket(), rspPayload) != 0)
+	    fail("getpacket() returned a different packet");
+	readFully(rspPeer, &csum, 1);
+
+	beginRow(len);
+	result("getpacket", len, 1e6 / callRate(opGetpacket));
+	result("putpacket", len, 1e6 / callRate(opPutpacket));
+	endRow();
+    }
+
+    delete [] rspPayload;
+    close(fds[0]);
+    close(fds[1]);
+    gdbFileDescriptor = -1;
+}
+
+/*
+ * JTAG ICE mkII frames, memory space decoding and breakpoint lookup.
+ *
+ * jtag2 insists on opening a serial device; a pseudo terminal serves
+ * for that, and is then replaced by one end of a socket pair.
+ */
+
+class bench_jtag2: public jtag2
+{
+  public:
+    bench_jtag2(const char *dev, int fd): jtag2(dev, (char *)"bench") {
+	close(jtagBox);
+	jtagBox = fd;
+	oldtioValid = false;
+    }
+
+    using jtag2::sendFrame;
+    using jtag2::recvFrame;
+    using jtag2::memorySpace;
+    using jtag2::jtagBox;
+};
+
+static bench_jtag2 *openBenchJtag(int &peer)
+{
+    int fds[2];
+    int pty = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if (pty < 0 || grantpt(pty) < 0 || unlockpt(pty) < 0)
+	fail("cannot allocate a pseudo terminal");
+    makeSocketPair(fds);
+
+    bench_jtag2 *j = new bench_jtag2(ptsname(pty), fds[0]);
+    close(pty);
+    peer = fds[1];
+
+    return j;
+}
+
+static bench_jtag2 *frameJtag;
+static int framePeer;
+static uchar *frameData;
+static uchar *frameBuf;
+static unsigned int frameLen;
+
+static void opSendFrame(void)
+{
+    frameJtag->sendFrame(frameData, frameLen);
+    readFully(framePeer, frameBuf, frameLen + 10);
+}
+
+static void opRecvFrame(void)
+{
+    uchar *msg;
+    unsigned short seqno;
+
+    writeFully(framePeer, frameBuf, frameLen + 10);
+    if (frameJtag->recvFrame(msg, seqno) != (int)frameLen)
+	fail("recvFrame() failed");
+    delete [] msg;
+}
+
+static void benchFrames(void)
+{
+    enum { MAXLEN = 16 * 1024 };
+    static const char *const columns[] = { "sendFrame", "recvFrame", NULL };
+
+    frameJtag = openBenchJtag(framePeer);
+    frameData = new uchar[MAXLEN];
+    frameBuf = new uchar[MAXLEN + 10];
+    fillRandom(frameData, MAXLEN);
+
+    beginTable("mkii-frame", "MB/s", "mkII frame encoding/decoding", columns);
+    for (frameLen = 16; frameLen <= MAXLEN; frameLen *= 4)
+    {
+	// Capture a frame as sent, to be received later on.
+	frameJtag->sendFrame(frameData, frameLen);
+	readFully(framePeer, frameBuf, frameLen + 10);
+	if (!crcverify(frameBuf, frameLen + 10) ||
+	    memcmp(frameBuf + 8, frameData, frameLen) != 0)
+	    fail("sendFrame() produced a bad frame");
+
+	beginRow(frameLen);
+	result("sendFrame", frameLen, callRate(opSendFrame) * frameLen / 1e6);
+	result("recvFrame", frameLen, callRate(opRecvFrame) * frameLen / 1e6);
+	endRow();
+    }
+
+    delete frameJtag;
+    delete [] frameData;
+    delete [] frameBuf;
+    close(framePeer);
+}
+
+enum { NUM_SPACE_ADDRS = 1024 };
+
+static unsigned long spaceAddrs[NUM_SPACE_ADDRS];
+static volatile uchar spaceSink;
+
+static void opMemorySpace(void)
+{
+    for (int i = 0; i < NUM_SPACE_ADDRS; i++)
+    {
+	unsigned long addr = spaceAddrs[i];
+
+	spaceSink = frameJtag->memorySpace(addr);
+    }
+}
+
+static void benchMemorySpace(void)
+{
+    static const unsigned long spaces[] =
+    {
+	FLASH_SPACE_ADDR_OFFSET, DATA_SPACE_ADDR_OFFSET,
+	EEPROM_SPACE_ADDR_OFFSET, FUSE_SPACE_ADDR_OFFSET,
+	LOCK_SPACE_ADDR_OFFSET, SIG_SPACE_ADDR_OFFSET,
+	REGISTER_SPACE_ADDR_OFFSET, BREAKPOINT_SPACE_ADDR_OFFSET,
+    };
+    static const char *const columns[] = { "flash", "data", "mixed", NULL };
+    int peer;
+
+    frameJtag = openBenchJtag(peer);
+
+    beginTable("memory-space", "ns", "memory space decoding, per address",
+	       columns);
+    beginRow(NUM_SPACE_ADDRS);
+    for (int k = 0; columns[k] != NULL; k++)
+    {
+	for (int i = 0; i < NUM_SPACE_ADDRS; i++)
+	{
+	    unsigned long space = k < 2? spaces[k]: spaces[rand() % 8];
+
+	    spaceAddrs[i] = space + (rand() & 0xffff);
+	}
+	result(columns[k], NUM_SPACE_ADDRS,
+	       1e9 / (callRate(opMemorySpace) * NUM_SPACE_ADDRS));
+    }
+    endRow();
+
+    delete frameJtag;
+    close(peer);
+}
+
+enum { NUM_BP_LOOKUPS = 256 };
+
+static volatile bool bpSink;
+
+static void opBreakpointAt(void)
+{
+    // Mostly misses, like the checks done while stepping.
+    for (unsigned int a = 0; a < 2 * NUM_BP_LOOKUPS; a += 2)
+	bpSink = frameJtag->codeBreakpointAt(a);
+}
+
+static void opBreakpointBetween(void)
+{
+    for (unsigned int a = 0; a < 2 * NUM_BP_LOOKUPS; a += 2)
+	bpSink = frameJtag->codeBreakpointBetween(a, a + 2);
+}
+
+static void benchBreakpoints(void)
+{
+    static const char *const columns[] = { "at", "between", NULL };
+    unsigned int numbp = 0;
+    int peer;
+
+    frameJtag = openBenchJtag(peer);
+    frameJtag->deviceDef = &deviceDefinitions[0];
+
+    beginTable("breakpoint-lookup", "ns", "code breakpoint lookup",
+	       columns);
+    for (unsigned int want = 1; want <= 64; want *= 4)
+    {
+	// Breakpoints well above the addresses looked up.
+	while (numbp < want &&
+	       frameJtag->addBreakpoint(0x10000 + 2 * numbp, CODE, 0))
+	    numbp++;
+	if (numbp < want)
+	    // The ICE cannot take any more.
+	    break;
+
+	beginRow(numbp);
+	result("at", numbp,
+	       1e9 / (callRate(opBreakpointAt) * NUM_BP_LOOKUPS));
+	result("between", numbp,
+	       1e9 / (callRate(opBreakpointBetween) * NUM_BP_LOOKUPS));
+	endRow();
+    }
+
+    delete frameJtag;
+    close(peer);
+}
+
+/*
+ * Flash image page scanning, as done when downloading a file to the
+ * target.  Reading the image itself requires libbfd, so the image is
+ * filled in directly.
+ */
+
+static BFDimage pageImage;
+static unsigned int pageSize;
+static volatile unsigned int pageSink;
+
+static void opPageScan(void)
+{
+    unsigned int n = 0;
+
+    for (unsigned int addr = 0; addr < pageImage.last_address;
+	 addr += pageSize)
+	if (!pageIsEmpty(&pageImage, addr, pageSize, MEM_FLASH))
+	    n++;
+    pageSink = n;
+}
+
+static void benchPageScan(void)
+{
+    enum { IMAGE_SIZE = 128 * 1024 };
+    static const char *const columns[] = { "program", "erased", NULL };
+
+    beginTable("page-scan", "MB/s", "flash image page scanning", columns);
+    for (pageSize = 64; pageSize <= 256; pageSize *= 2)
+    {
+	beginRow(pageSize);
+	for (int k = 0; columns[k] != NULL; k++)
+	{
+	    // A program image is non-empty right at the start of each
+	    // page; an image of erased flash has to be scanned fully.
+	    for (unsigned int i = 0; i < IMAGE_SIZE; i++)
+	    {
+		pageImage.image[i].val = k == 0? rand() >> 7: 0xff;
+		pageImage.image[i].used = true;
+	    }
+	    pageImage.last_address = IMAGE_SIZE;
+	    pageImage.first_address = 0;
+	    pageImage.first_address_ok = pageImage.has_data = true;
+
+	    result(columns[k], pageSize,
+		   callRate(opPageScan) * IMAGE_SIZE / 1e6);
+	}
+	endRow();
+    }
+}
+
+/*
+ * Device lookup by name and JTAG ID, as at startup.  The reference
+ * versions are the linear searches used before devdescr.cc had hash
+ * tables.
+ */
+
+static unsigned int numDevices;
+static jtag_device_def_type *volatile deviceSink;
+
+static jtag_device_def_type *refFindName(const char *name)
+{
+    for (jtag_device_def_type *dev = deviceDefinitions; dev->name; dev++)
+	if (strcasecmp(dev->name, name) == 0)
+	    return dev;
+    return NULL;
+}
+
+static jtag_device_def_type *refFindId(unsigned int id)
+{
+    for (jtag_device_def_type *dev = deviceDefinitions; dev->name; dev++)
+	if (dev->device_id == id)
+	    return dev;
+    return NULL;
+}
+
+static void opRefName(void)
+{
+    for (unsigned int i = 0; i < numDevices; i++)
+	deviceSink = refFindName(deviceDefinitions[i].name);
+}
+
+static void opHashName(void)
+{
+    for (unsigned int i = 0; i < numDevices; i++)
+	deviceSink = findDeviceByName(deviceDefinitions[i].name);
+}
+
+static void opRefId(void)
+{
+    for (unsigned int i = 0; i < numDevices; i++)
+	deviceSink = refFindId(deviceDefinitions[i].device_id);
+}
+
+static void opHashId(void)
+{
+    for (unsigned int i = 0; i < numDevices; i++)
+	deviceSink = findDeviceById(deviceDefinitions[i].device_id);
+}
+
+static void benchDevices(void)
+{
+    static const char *const columns[] =
+	{ "scan-name", "hash-name", "scan-id", "hash-id", NULL };
+    static void (*const ops[])(void) =
+	{ opRefName, opHashName, opRefId, opHashId };
+
+    for (numDevices = 0; deviceDefinitions[numDevices].name; numDevices++)
+	if (findDeviceByName(deviceDefinitions[numDevices].name) !=
+	    refFindName(deviceDefinitions[numDevices].name) ||
+	    findDeviceById(deviceDefinitions[numDevices].device_id) !=
+	    refFindId(deviceDefinitions[numDevices].device_id))
+	    fail("device lookup differs from linear search");
+    if (findDeviceByName("atnothing") != NULL ||
+	findDeviceById(0xffff) != NULL)
+	fail("device lookup found a nonexistent device");
+
+    beginTable("device-lookup", "ns", "device lookup", columns);
+    beginRow(numDevices);
+    for (int k = 0; columns[k] != NULL; k++)
+	result(columns[k], numDevices, 1e9 / (callRate(ops[k]) * numDevices));
+    endRow();
+}
+
+/*
+ * Target console throughput.
+ *
+ * A child process plays a JTAG ICE mkII on the other end of the socket
+ * pair, with a firmware that refills the console as soon as it has
+ * been drained, so every drain moves a full buffer.  The transports
+ * are modelled by delaying each response: serial lines by the time the
+ * command and response frames take on the wire, USB by a 1 ms frame
+ * for either direction.  The ICE's own time for accessing the target
+ * is not included.
+ */
+
+enum
+{
+    CONSOLE_ADDR	= 0x100,	// in the data space
+    USB_FRAME_USEC	= 1000,
+};
+
+static unsigned long b4(const uchar *b)
+{
+    return b[0] | (b[1] << 8) | ((unsigned long)b[2] << 16) |
+	((unsigned long)b[3] << 24);
+}
+
+static bool peerRead(int fd, uchar *buf, unsigned int len)
+{
+    while (len > 0)
+    {
+	ssize_t n = read(fd, buf, len);
+
+	if (n <= 0)
+	    return false;
+	buf += n;
+	len -= n;
+    }
+    return true;
+}
+
+/** Answer memory reads and writes on 'fd' until it is closed.  'baud'
+    is the serial line speed, or 0 for USB, or -1 for no delay at all.
+**/
+static void consolePeer(int fd, unsigned int ringSize, long baud)
+{
+    uchar sram[CONSOLE_HEADER_SIZE + CONSOLE_MAX_SIZE];
+    uchar hdr[8], body[CONSOLE_HEADER_SIZE + CONSOLE_MAX_SIZE + 12];
+    uchar resp[CONSOLE_HEADER_SIZE + CONSOLE_MAX_SIZE + 11];
+
+    fillRandom(sram, sizeof sram);
+    sram[0] = ringSize;
+    sram[1] = ringSize;		// full
+    sram[2] = sram[3] = 0;
+
+    while (peerRead(fd, hdr, 8))
+    {
+	unsigned long len = b4(hdr + 3);
+
+	if (len + 2 > sizeof body || !peerRead(fd, body, len + 2))
+	    _exit(1);
+
+	unsigned long n = b4(body + 2), addr = (b4(body + 6) & 0xffff) -
+	    CONSOLE_ADDR;
+	unsigned int rlen = 1;
+
+	if (addr + n > sizeof sram)
+	    resp[8] = RSP_FAILED;
+	else if (body[0] == CMND_READ_MEMORY)
+	{
+	    resp[8] = RSP_MEMORY;
+	    memcpy(resp + 9, sram + addr, n);
+	    rlen += n;
+	}
+	else if (body[0] == CMND_WRITE_MEMORY)
+	{
+	    memcpy(sram + addr, body + 10, n);
+	    sram[1] = sram[2] + ringSize;
+	    resp[8] = RSP_OK;
+	}
+	else
+	    resp[8] = RSP_FAILED;
+
+	memcpy(resp, hdr, 3);		// start and sequence number
+	resp[3] = rlen;
+	resp[4] = resp[5] = resp[6] = 0;
+	resp[7] = TOKEN;
+	crcappend(resp, rlen + 8);
+
+	if (baud == 0)
+	    usleep(2 * USB_FRAME_USEC);
+	else if (baud > 0)
+	    usleep((len + rlen + 20) * 10 * 1000000ULL / baud);
+	if (write(fd, resp, rlen + 10) != (ssize_t)(rlen + 10))
+	    _exit(1);
+    }
+    _exit(0);
+}
+
+static void opConsoleDrain(void)
+{
+    consoleDrain();
+}
+
+static void benchConsole(void)
+{
+    static const char *const columns[] =
+	{ "local", "usb", "115200", "19200", NULL };
+    static const long bauds[] = { -1, 0, 115200, 19200 };
+
+    beginTable("console", "kB/s", "target console throughput", columns);
+    for (unsigned int ringSize = 16; ringSize <= CONSOLE_MAX_SIZE;
+	 ringSize *= 2)
+    {
+	beginRow(ringSize);
+	for (int k = 0; columns[k] != NULL; k++)
+	{
+	    int peer;
+	    bench_jtag2 *j = openBenchJtag(peer);
+
+	    fflush(stdout);
+	    pid_t pid = fork();
+	    if (pid < 0)
+		fail("cannot fork");
+	    if (pid == 0)
+	    {
+		close(j->jtagBox);
+		consolePeer(peer, ringSize, bauds[k]);
+	    }
+	    close(peer);
+
+	    theJtagICE = j;
+	    if (!consoleAttach(DATA_SPACE_ADDR_OFFSET + CONSOLE_ADDR,
+			       CONSOLE_HEADER_SIZE + ringSize, "/dev/null"))
+		fail("cannot attach the console");
+	    if (consoleDrain() != ringSize)
+		fail("consoleDrain() did not drain the console");
+
+	    result(columns[k], ringSize,
+		   callRate(opConsoleDrain) * ringSize / 1e3);
+
+	    close(j->jtagBox);
+	    delete j;
+	    theJtagICE = NULL;
+	    waitpid(pid, NULL, 0);
+	}
+	endRow();
+    }
+}
+
+/*
+ * JTAG ICE mkI memory transfers.
+ *
+ * A child process plays the mkI on the master side of a pseudo
+ * terminal, so the line is a real tty as far as jtag1 is concerned.
+ * Reads and writes are split into 256 location commands; the serial
+ * line is modelled by delaying each response by the time the command
+ * and response take on the wire.
+ */
+
+enum
+{
+    MKI_ADDR		= 0x100,	// in the data space
+    MKI_MAXLEN		= 16 * 1024,
+};
+
+/** Answer mkI memory reads and writes on 'fd' until it is closed.
+    'baud' is the serial line speed, or 0 for no delay at all.
+**/
+static void mkIPeer(int fd, long baud)
+{
+    uchar cmd[256 + 3], resp[256 + 3];
+    unsigned int pending = 0;
+
+    fillRandom(resp, sizeof resp);
+    resp[0] = JTAG_R_OK;
+
+    while (peerRead(fd, cmd, 1))
+    {
+	unsigned int clen, rlen;
+
+	if (cmd[0] == 'R' || cmd[0] == 'W')
+	{
+	    clen = 8;
+	    if (!peerRead(fd, cmd + 1, clen - 1))
+		_exit(1);
+	    if (cmd[0] == 'R')
+	    {
+		rlen = cmd[2] + 1 + 3;	// 'A', data, 0, 'A'
+		resp[rlen - 2] = 0;
+		resp[rlen - 1] = JTAG_R_OK;
+	    }
+	    else
+	    {
+		pending = cmd[2] + 1;
+		rlen = 1;
+	    }
+	}
+	else if (cmd[0] == 'h' && pending > 0)
+	{
+	    clen = pending + 3;
+	    if (!peerRead(fd, cmd + 1, clen - 1))
+		_exit(1);
+	    pending = 0;
+	    resp[1] = JTAG_R_OK;
+	    rlen = 2;
+	}
+	else
+	    _exit(1);
+
+	if (baud > 0)
+	    usleep((clen + rlen) * 10 * 1000000ULL / baud);
+	if (write(fd, resp, rlen) != (ssize_t)rlen)
+	    _exit(1);
+	fillRandom(resp + 1, 2);
+    }
+    _exit(0);
+}
+
+class bench_jtag1: public jtag1
+{
+  public:
+    bench_jtag1(const char *dev): jtag1(dev, (char *)"bench") {}
+
+    using jtag1::jtagBox;
+};
+
+static bench_jtag1 *mkIJtag;
+static uchar *mkIData;
+static unsigned int mkILen;
+
+static void opMkIRead(void)
+{
+    uchar *mem = mkIJtag->jtagRead(DATA_SPACE_ADDR_OFFSET + MKI_ADDR, mkILen);
+
+    if (mem == NULL)
+	fail("jtagRead() failed");
+    delete [] mem;
+}
+
+static void opMkIWrite(void)
+{
+    mkIJtag->jtagWrite(DATA_SPACE_ADDR_OFFSET + MKI_ADDR, mkILen, mkIData);
+}
+
+static void benchMkI(void)
+{
+    static const char *const columns[] =
+	{ "read", "write", "read-115200", "write-115200", NULL };
+    static const long bauds[] = { 0, 0, 115200, 115200 };
+
+    mkIData = new uchar[MKI_MAXLEN];
+    fillRandom(mkIData, MKI_MAXLEN);
+
+    beginTable("mki", "kB/s", "JTAG ICE mkI memory transfers", columns);
+    for (mkILen = 256; mkILen <= MKI_MAXLEN; mkILen *= 4)
+    {
+	beginRow(mkILen);
+	for (int k = 0; columns[k] != NULL; k++)
+	{
+	    int pty = posix_openpt(O_RDWR | O_NOCTTY);
+
+	    if (pty < 0 || grantpt(pty) < 0 || unlockpt(pty) < 0)
+		fail("cannot allocate a pseudo terminal");
+	    mkIJtag = new bench_jtag1(ptsname(pty));
+
+	    fflush(stdout);
+	    pid_t pid = fork();
+	    if (pid < 0)
+		fail("cannot fork");
+	    if (pid == 0)
+	    {
+		close(mkIJtag->jtagBox);
+		mkIPeer(pty, bauds[k]);
+	    }
+	    close(pty);
+
+	    result(columns[k], mkILen, callRate(k % 2 == 0? opMkIRead:
+						 opMkIWrite) * mkILen / 1e3);
+
+	    close(mkIJtag->jtagBox);
+	    delete mkIJtag;
+	    waitpid(pid, NULL, 0);
+	}
+	endRow();
+    }
+    delete [] mkIData;
+}
+
+static const struct
+{
+    const char *name;
+    void (*run)(void);
+} benchmarks[] =
+{
+    { "hex",		benchHex },
+    { "crc",		benchCrc },
+    { "rsp",		benchRsp },
+    { "frame",		benchFrames },
+    { "space",		benchMemorySpace },
+    { "bp",		benchBreakpoints },
+    { "page",		benchPageScan },
+    { "device",		benchDevices },
+    { "console",	benchConsole },
+    { "mki",		benchMkI },
+    { 0, 0 }
+};
+
+int main(int argc, char **argv)
+{
+    int first = 1;
+
+    srand(1);
+
+    if (argc > 1 && strcmp(argv[1], "--json") == 0)
+    {
+	jsonOutput = true;
+	first++;
+    }
+    for (int j = first; j < argc; j++)
+    {
+	int i;
+
+	for (i = 0; benchmarks[i].name != NULL; i++)
+	    if (strcmp(argv[j], benchmarks[i].name) == 0)
+		break;
+	if (benchmarks[i].name == NULL)
+	{
+	    fprintf(stderr, "Usage: %s [--json] [benchmark...]\n"
+		    "Benchmarks:", argv[0]);
+	    for (i = 0; benchmarks[i].name != NULL; i++)
+		fprintf(stderr, " %s", benchmarks[i].name);
+	    fprintf(stderr, "\n");
+	    return 1;
+	}
+    }
+
+    if (jsonOutput)
+	printf("{\n  \"program\": \"avarice-bench\",\n"
+	       "  \"version\": \"%s\",\n  \"results\": [", PACKAGE_VERSION);
+
+    try
+    {
+	for (int i = 0; benchmarks[i].name != NULL; i++)
+	{
+	    bool selected = argc == first;
+
+	    for (int j = first; j < argc; j++)
+		if (strcmp(argv[j], benchmarks[i].name) == 0)
+		    selected = true;
+	    if (selected)
+		benchmarks[i].run();
+	}
+    }
+    catch (jtag_exception& e)
+    {
+	fprintf(stderr, "avarice-bench: %s\n", e.what());
+	return 1;
+    }
+
+    if (jsonOutput)
+	printf("\n  ]\n}\n");
+
+    return 0;
+}
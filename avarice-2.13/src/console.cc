@@ -0,0 +1,243 @@
+/*
+ *	avarice - The "avarice" program.
+ *
+ *	This program is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License Version 2
+ *	as published by the Free Software Foundation.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111, USA.
+ *
+ * This file implements the target console: draining the firmware's
+ * output from a ring buffer in SRAM, whenever the target stops and,
+ * optionally, periodically while it runs.
+ *
+ * None of the ICEs can read SRAM while the target runs, so polling
+ * briefly stops the target.  The ICE's break event for that stop
+ * would also swallow one for a breakpoint hit at the same time, so
+ * the PC is checked against the breakpoints before resuming.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "avarice.h"
+#include "jtag.h"
+#include "remote.h"
+#include "symbols.h"
+#include "console.h"
+
+enum
+{
+    // Longest piece of output per 'O' packet: "O" plus two hex digits
+    // per byte has to fit into BUFMAX.
+    CONSOLE_GDB_CHUNK	= (BUFMAX - 1) / 2,
+};
+
+static unsigned long consoleAddr;
+static unsigned int consoleSize;	// 0 if disabled
+static FILE *consoleFile;		// NULL for GDB's console
+
+bool consoleAttach(unsigned long addr, unsigned int size, const char *output)
+{
+    if (size < CONSOLE_HEADER_SIZE + 2)
+    {
+	fprintf(stderr, "%s is too small for a console\n", CONSOLE_SYMBOL);
+	return false;
+    }
+    if (size > CONSOLE_HEADER_SIZE + CONSOLE_MAX_SIZE)
+	size = CONSOLE_HEADER_SIZE + CONSOLE_MAX_SIZE;
+
+    if (consoleFile != NULL)
+    {
+	fclose(consoleFile);
+	consoleFile = NULL;
+    }
+    if (output != NULL)
+    {
+	consoleFile = fopen(output, "w");
+	if (consoleFile == NULL)
+	{
+	    fprintf(stderr, "Cannot open console output %s: %s\n", output,
+		    strerror(errno));
+	    return false;
+	}
+    }
+    consoleAddr = addr;
+    consoleSize = size;
+
+    return true;
+}
+
+/** Write 'len' bytes of target output to the console output. **/
+static void consoleWrite(const uchar *data, unsigned int len)
+{
+    if (consoleFile != NULL)
+    {
+	fwrite(data, 1, len, consoleFile);
+	fflush(consoleFile);
+    }
+    else if (gdbFileDescriptor >= 0)
+    {
+	// gdbOut() takes a C string, so NULs are dropped.
+	char chunk[CONSOLE_GDB_CHUNK + 1];
+	unsigned int n = 0;
+
+	for (unsigned int i = 0; i < len; i++)
+	{
+	    if (data[i] != '\0')
+		chunk[n++] = data[i];
+	    if (n == CONSOLE_GDB_CHUNK || (i == len - 1 && n > 0))
+	    {
+		chunk[n] = '\0';
+		gdbOut("%s", chunk);
+		n = 0;
+	    }
+	}
+    }
+    else
+	fwrite(data, 1, len, stderr);
+}
+
+unsigned int consoleDrain(void)
+{
+    if (consoleSize == 0)
+	return 0;
+
+    uchar *mem;
+    try
+    {
+	mem = theJtagICE->jtagRead(consoleAddr, consoleSize);
+    }
+    catch (jtag_exception& e)
+    {
+	debugOut("console: cannot read %s: %s\n", CONSOLE_SYMBOL, e.what());
+	return 0;
+    }
+    if (mem == NULL)
+    {
+	debugOut("console: cannot read %s\n", CONSOLE_SYMBOL);
+	return 0;
+    }
+
+    unsigned int size = mem[0];
+    uchar head = mem[1], tail = mem[2], dropped = mem[3];
+    unsigned int count = (uchar)(head - tail);
+
+    // Before the firmware initialized the console, anything goes.
+    if (size < 2 || size > consoleSize - CONSOLE_HEADER_SIZE ||
+	(size & (size - 1)) != 0 || count > size)
+    {
+	debugOut("console: not initialized (size %u, head %u, tail %u)\n",
+		 size, head, tail);
+	delete [] mem;
+	return 0;
+    }
+
+    if (count > 0)
+    {
+	uchar out[CONSOLE_MAX_SIZE];
+	const uchar *buf = mem + CONSOLE_HEADER_SIZE;
+
+	for (unsigned int i = 0; i < count; i++)
+	    out[i] = buf[(tail + i) & (size - 1)];
+	consoleWrite(out, count);
+    }
+    if (dropped > 0)
+    {
+	char msg[64];
+	int len = snprintf(msg, sizeof msg,
+			   "\n[console: %u%s bytes lost]\n",
+			   dropped, dropped == 0xff? " or more": "");
+
+	consoleWrite((const uchar *)msg, len);
+    }
+    delete [] mem;
+
+    if (count > 0 || dropped > 0)
+    {
+	// Hand the space back, and restart counting lost bytes.
+	uchar update[2] = { head, 0 };
+
+	try
+	{
+	    theJtagICE->jtagWrite(consoleAddr + 2, 2, update);
+	}
+	catch (jtag_exception& e)
+	{
+	    debugOut("console: cannot update %s: %s\n", CONSOLE_SYMBOL,
+		     e.what());
+	}
+    }
+
+    return count;
+}
+
+/** jtag::pollHook: stop the target, drain the console, and resume
+    unless the target stopped at a breakpoint.
+**/
+static bool consolePoll(void)
+{
+    unsigned long long bt = theJtagICE->breakTimestamp;
+
+    theJtagICE->interruptProgram();
+    theJtagICE->breakTimestamp = bt;
+
+    consoleDrain();
+
+    if (theJtagICE->codeBreakpointAt(theJtagICE->getProgramCounter()))
+    {
+	theJtagICE->breakTimestamp = getTimeUsec();
+	return true;
+    }
+    theJtagICE->resumeProgram();
+    return false;
+}
+
+bool consoleEnable(const char *output, unsigned long long pollUsec)
+{
+    unsigned long addr;
+    unsigned int size;
+
+    if (!symbolsLoaded())
+    {
+	fprintf(stderr, "The console needs a --symbols file to find %s\n",
+		CONSOLE_SYMBOL);
+	return false;
+    }
+    if (!lookupSymbol(CONSOLE_SYMBOL, addr, size))
+    {
+	fprintf(stderr, "No symbol %s in the --symbols file\n",
+		CONSOLE_SYMBOL);
+	return false;
+    }
+    if ((addr & ADDR_SPACE_MASK) != DATA_SPACE_ADDR_OFFSET)
+    {
+	fprintf(stderr, "%s is not in SRAM\n", CONSOLE_SYMBOL);
+	return false;
+    }
+    if (size == 0)
+    {
+	fprintf(stderr, "%s has no size (missing .size directive?)\n",
+		CONSOLE_SYMBOL);
+	return false;
+    }
+    if (!consoleAttach(addr, size, output))
+	return false;
+
+    if (pollUsec != 0)
+    {
+	theJtagICE->pollInterval = pollUsec;
+	theJtagICE->pollHook = consolePoll;
+    }
+
+    return true;
+}
@@ -0,0 +1,65 @@
+/*
+ *	avarice - The "avarice" program.
+ *
+ *	This program is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License Version 2
+ *	as published by the Free Software Foundation.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111, USA.
+ *
+ * Interface definition for the target console (console.cc).
+ *
+ * The firmware writes its output into a ring buffer in SRAM at symbol
+ * CONSOLE_SYMBOL (see target/avarice_console.h):
+ *
+ *   offset 0: size of the buffer, a power of two from 2 to 128
+ *   offset 1: head, bytes ever written, modulo 256 (firmware)
+ *   offset 2: tail, bytes ever read, modulo 256 (avarice)
+ *   offset 3: bytes dropped because the buffer was full, saturating
+ *             at 255 (firmware; avarice clears it when draining)
+ *   offset 4: the buffer
+ *
+ * All of it is read at once, so a drain costs one memory read and one
+ * two byte write (tail and dropped), whatever the amount of output.
+ */
+
+#ifndef INCLUDE_CONSOLE_H
+#define INCLUDE_CONSOLE_H
+
+#define CONSOLE_SYMBOL "__avarice_console"
+
+enum
+{
+    CONSOLE_HEADER_SIZE	= 4,
+    CONSOLE_MAX_SIZE	= 128,
+};
+
+/** Look up CONSOLE_SYMBOL in the --symbols file, and drain the
+    console into 'output' (GDB's console, or stderr without GDB, if
+    NULL).  If 'pollUsec' is not 0, the console is also drained every
+    'pollUsec' us while the target runs.
+
+    Returns false (after printing a diagnostic to stderr) if the
+    symbol or the output file are not usable.
+**/
+bool consoleEnable(const char *output, unsigned long long pollUsec);
+
+/** As consoleEnable(), for a console of 'size' bytes (header included)
+    at 'addr', without polling.  Used by avarice-bench.
+**/
+bool consoleAttach(unsigned long addr, unsigned int size, const char *output);
+
+/** Copy whatever the stopped target wrote since the last drain to the
+    output.  Does nothing unless the console is enabled.  Returns the
+    number of bytes drained.
+**/
+unsigned int consoleDrain(void);
+
+#endif /* INCLUDE_CONSOLE_H */
@@ -0,0 +1,342 @@
+/*
+ *	avarice - The "avarice" program.
+ *
+ *	This program is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License Version 2
+ *	as published by the Free Software Foundation.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111, USA.
+ *
+ * This file implements writing a snapshot of the target state as an
+ * ELF core file.
+ *
+ * Each memory space becomes a PT_LOAD segment at the address GDB uses
+ * for it (data space at 0x800000, EEPROM at 0x810000), so avr-gdb can
+ * examine the memory of the core file together with the application's
+ * ELF file.  As there is no standard AVR register note, the CPU
+ * registers are stored in an "AVaRICE" note, in the layout of GDB's
+ * 'g' packet.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "avarice.h"
+#include "jtag.h"
+#include "remote.h"
+#include "symbols.h"
+#include "elfdefs.h"
+#include "coredump.h"
+
+enum
+{
+    NUM_CORE_REGBYTES	= 32 + 1 + 2 + 4,
+};
+
+struct core_segment
+{
+    unsigned long addr;
+    unsigned long size;
+    unsigned int flags;
+    uchar *data;
+    bool owned;			// data to be deleted with the segment
+};
+
+/** Read 'size' bytes from target address 'addr' into 'buf', using
+    as few transfers as the ICE allows.
+**/
+static void readBlock(unsigned long addr, unsigned long size, uchar *buf)
+{
+    unsigned int chunk = theJtagICE->maxReadSize();
+
+    while (size > 0)
+    {
+	unsigned int n = size > chunk? chunk: size;
+	uchar *mem = theJtagICE->jtagRead(addr, n);
+
+	if (mem == NULL)
+	    throw jtag_exception("reading target memory failed");
+	memcpy(buf, mem, n);
+	delete [] mem;
+
+	addr += n;
+	buf += n;
+	size -= n;
+    }
+}
+
+void readDataSpace(uchar *buf, unsigned long size)
+{
+    gdb_io_reg_def_type *ioregs = theJtagICE->deviceDef->io_reg_defs;
+    unsigned long from = 0;
+
+    memset(buf, 0, size);
+    for (;;)
+    {
+	// Find the next register to skip.
+	unsigned long skip = size;
+	for (int i = 0; ioregs != NULL && ioregs[i].name != NULL; i++)
+	    if (ioregs[i].flags != 0 && ioregs[i].reg_addr >= from &&
+		ioregs[i].reg_addr < skip)
+		skip = ioregs[i].reg_addr;
+
+	readBlock(DATA_SPACE_ADDR_OFFSET + from, skip - from, buf + from);
+	if (skip >= size)
+	    break;
+	from = skip + 1;
+    }
+}
+
+unsigned long resolveRamEnd(unsigned long ramEnd,
+			    void (*report)(const char *fmt, ...))
+{
+    unsigned long addr;
+    unsigned int size;
+
+    if (ramEnd != 0)
+	return ramEnd;
+    if (lookupSymbol("__stack", addr, size))
+	return addr & ~ADDR_SPACE_MASK;
+
+    report("RAMEND unknown, assuming 0x%x.\n", DEFAULT_RAMEND);
+    return DEFAULT_RAMEND;
+}
+
+/** Add a segment of 'size' bytes at target address 'addr' to 'segs',
+    and fill it from the target.
+**/
+static void readSegment(core_segment *segs, unsigned int &nsegs,
+			unsigned long addr, unsigned long size,
+			unsigned int flags)
+{
+    core_segment *seg = &segs[nsegs++];
+
+    seg->addr = addr;
+    seg->size = size;
+    seg->flags = flags;
+    seg->data = new uchar[size];
+    seg->owned = true;
+    if (addr == DATA_SPACE_ADDR_OFFSET)
+	readDataSpace(seg->data, size);
+    else
+	readBlock(addr, size, seg->data);
+}
+
+static void readRegisters(uchar *regs)
+{
+    uchar *mem = theJtagICE->jtagRead(theJtagICE->cpuRegisterAreaAddress(),
+				      32);
+    if (mem == NULL)
+	throw jtag_exception("reading CPU registers failed");
+    memcpy(regs, mem, 32);
+    delete [] mem;
+
+    // We get SPL SPH SREG and need SREG SPL SPH
+    mem = theJtagICE->jtagRead(theJtagICE->statusAreaAddress(), 3);
+    if (mem == NULL)
+	throw jtag_exception("reading CPU status failed");
+    regs[32] = mem[2];
+    regs[33] = mem[0];
+    regs[34] = mem[1];
+    delete [] mem;
+
+    elfPutU32(regs + 35, theJtagICE->getProgramCounter());
+}
+
+/** Append an ELF note of 'type' with 'desclen' bytes of 'desc' to
+    'buf', returning the new end of 'buf'.
+**/
+static uchar *putNote(uchar *buf, unsigned int type, const void *desc,
+		      unsigned int desclen)
+{
+    static const char name[8] = "AVaRICE";
+
+    elfPutU32(buf, sizeof name);
+    elfPutU32(buf + 4, desclen);
+    elfPutU32(buf + 8, type);
+    memcpy(buf + 12, name, sizeof name);
+    buf += 12 + sizeof name;
+    memset(buf, 0, (desclen + 3) & ~3);
+    memcpy(buf, desc, desclen);
+
+    return buf + ((desclen + 3) & ~3);
+}
+
+static bool writeCore(const char *filename, const uchar *regs,
+		      const core_segment *segs, unsigned int nsegs)
+{
+    const char *devname = theJtagICE->deviceDef->name;
+    unsigned int devlen = strlen(devname) + 1;
+    unsigned int phnum = nsegs + 1;
+    unsigned int notesize = (12 + 8 + ((NUM_CORE_REGBYTES + 3) & ~3)) +
+	(12 + 8 + ((devlen + 3) & ~3));
+    unsigned int hdrsize = EH_SIZE + phnum * PH_SIZEOF + notesize;
+    uchar *hdr = new uchar[hdrsize];
+    unsigned long offset;
+
+    memset(hdr, 0, hdrsize);
+
+    memcpy(hdr, "\177ELF", 4);
+    hdr[4] = ELFCLASS32;
+    hdr[5] = ELFDATA2LSB;
+    hdr[6] = EV_CURRENT;
+    elfPutU16(hdr + EH_TYPE, ET_CORE);
+    elfPutU16(hdr + EH_MACHINE, EM_AVR);
+    elfPutU32(hdr + EH_VERSION, EV_CURRENT);
+    elfPutU32(hdr + EH_PHOFF, EH_SIZE);
+    elfPutU16(hdr + EH_EHSIZE, EH_SIZE);
+    elfPutU16(hdr + EH_PHENTSIZE, PH_SIZEOF);
+    elfPutU16(hdr + EH_PHNUM, phnum);
+
+    uchar *ph = hdr + EH_SIZE;
+    offset = EH_SIZE + phnum * PH_SIZEOF;
+    elfPutU32(ph + PH_TYPE, PT_NOTE);
+    elfPutU32(ph + PH_OFFSET, offset);
+    elfPutU32(ph + PH_FILESZ, notesize);
+    elfPutU32(ph + PH_FLAGS, PF_R);
+    elfPutU32(ph + PH_ALIGN, 4);
+    offset += notesize;
+
+    for (unsigned int i = 0; i < nsegs; i++)
+    {
+	ph += PH_SIZEOF;
+	elfPutU32(ph + PH_TYPE, PT_LOAD);
+	elfPutU32(ph + PH_OFFSET, offset);
+	elfPutU32(ph + PH_VADDR, segs[i].addr);
+	elfPutU32(ph + PH_PADDR, segs[i].addr);
+	elfPutU32(ph + PH_FILESZ, segs[i].size);
+	elfPutU32(ph + PH_MEMSZ, segs[i].size);
+	elfPutU32(ph + PH_FLAGS, segs[i].flags);
+	elfPutU32(ph + PH_ALIGN, 1);
+	offset += segs[i].size;
+    }
+
+    uchar *note = hdr + EH_SIZE + phnum * PH_SIZEOF;
+    note = putNote(note, NT_AVARICE_REGS, regs, NUM_CORE_REGBYTES);
+    putNote(note, NT_AVARICE_DEVICE, devname, devlen);
+
+    FILE *f = fopen(filename, "wb");
+    bool ok = f != NULL && fwrite(hdr, 1, hdrsize, f) == hdrsize;
+    for (unsigned int i = 0; ok && i < nsegs; i++)
+	ok = fwrite(segs[i].data, 1, segs[i].size, f) == segs[i].size;
+    if (f != NULL && fclose(f) != 0)
+	ok = false;
+    delete [] hdr;
+
+    return ok;
+}
+
+bool dumpCore(const char *filename, bool withFlash, unsigned long ramEnd,
+	      bool toGdb)
+{
+    void (*report)(const char *fmt, ...) = toGdb? gdbOut: statusOut;
+    jtag_device_def_type *dev = theJtagICE->deviceDef;
+    unsigned long flashSize = dev->flash_page_size * dev->flash_page_count;
+    unsigned long eepromSize = dev->eeprom_page_size * dev->eeprom_page_count;
+    unsigned long pageSize = dev->flash_page_size;
+    // Data, EEPROM, and at most one segment per other flash page.
+    unsigned int maxsegs = 2 + (withFlash? (dev->flash_page_count + 1) / 2: 0);
+    core_segment *segs = new core_segment[maxsegs];
+    unsigned int nsegs = 0, samePages = 0;
+    unsigned long bytesRead = 0;
+    uchar regs[NUM_CORE_REGBYTES], *flash = NULL;
+    bool ok = false;
+
+    ramEnd = resolveRamEnd(ramEnd, report);
+
+    unsigned long long start = getTimeUsec(), readTime = 0;
+
+    try
+    {
+	readRegisters(regs);
+	bytesRead += NUM_CORE_REGBYTES;
+
+	readSegment(segs, nsegs, DATA_SPACE_ADDR_OFFSET, ramEnd + 1,
+		    PF_R | PF_W);
+	bytesRead += ramEnd + 1;
+
+	if (eepromSize != 0)
+	{
+	    readSegment(segs, nsegs, EEPROM_SPACE_ADDR_OFFSET, eepromSize,
+			PF_R | PF_W);
+	    bytesRead += eepromSize;
+	}
+
+	if (withFlash)
+	{
+	    unsigned long imageSize;
+	    const uchar *image = elfFlashImage(imageSize);
+	    core_segment *run = NULL;
+
+	    flash = new uchar[flashSize];
+	    for (unsigned long addr = 0; addr < flashSize; addr += pageSize)
+	    {
+		uchar *page = flash + addr;
+		bool same = image != NULL;
+
+		readBlock(addr, pageSize, page);
+		bytesRead += pageSize;
+
+		for (unsigned long i = 0; same && i < pageSize; i++)
+		    same = page[i] == (addr + i < imageSize? image[addr + i]:
+				       0xff);
+		if (same)
+		{
+		    samePages++;
+		    run = NULL;
+		    continue;
+		}
+
+		// Extend the current run of differing pages, or start
+		// a new one.
+		if (run == NULL)
+		{
+		    run = &segs[nsegs++];
+		    run->addr = addr;
+		    run->size = 0;
+		    run->flags = PF_R | PF_X;
+		    run->data = page;
+		    run->owned = false;
+		}
+		run->size += pageSize;
+	    }
+	}
+
+	readTime = getTimeUsec() - start;
+	ok = writeCore(filename, regs, segs, nsegs);
+	if (!ok)
+	    report("Cannot write core file %s\n", filename);
+    }
+    catch (jtag_exception& e)
+    {
+	report("Core dump failed: %s\n", e.what());
+    }
+
+    for (unsigned int i = 0; i < nsegs; i++)
+	if (segs[i].owned)
+	    delete [] segs[i].data;
+    delete [] segs;
+    delete [] flash;
+
+    if (!ok)
+	return false;
+
+    unsigned long long elapsed = getTimeUsec() - start;
+    report("Core dumped to %s: %lu bytes read in %.3f s (%.0f bytes/s)\n",
+	   filename, bytesRead, readTime / 1e6,
+	   readTime? bytesRead * 1e6 / readTime: 0.0);
+    if (withFlash)
+	report("%u of %lu flash pages identical to the ELF file, "
+	       "not included\n", samePages, flashSize / pageSize);
+    report("Target halted %.3f s for the dump\n", elapsed / 1e6);
+
+    return true;
+}
@@ -0,0 +1,67 @@
+/*
+ *	avarice - The "avarice" program.
+ *
+ *	This program is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License Version 2
+ *	as published by the Free Software Foundation.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111, USA.
+ *
+ * Interface definition for the ELF core dump writer (coredump.cc).
+ */
+
+#ifndef INCLUDE_COREDUMP_H
+#define INCLUDE_COREDUMP_H
+
+enum
+{
+    // Note types in the "AVaRICE" core file note.
+    NT_AVARICE_REGS	= 1,	// r0..r31, SREG, SP, PC in GDB's layout
+    NT_AVARICE_DEVICE	= 2,	// device name, NUL-terminated
+
+    // Assumed last data space address if neither given nor known
+    // from the ELF file (ATmega128).
+    DEFAULT_RAMEND	= 0x10ff,
+};
+
+/** Read the first 'size' bytes of the data space into 'buf'.  IO
+    registers with read side effects (like UDR) are skipped and left
+    as 0, so taking a snapshot does not disturb the target.
+**/
+void readDataSpace(unsigned char *buf, unsigned long size);
+
+/** Return 'ramEnd' if non-zero, else the last data space address as
+    given by the __stack symbol of the ELF file, or DEFAULT_RAMEND
+    (reporting that through 'report').
+**/
+unsigned long resolveRamEnd(unsigned long ramEnd,
+			    void (*report)(const char *fmt, ...));
+
+/** Write the complete state of the (stopped) target to the ELF core
+    file 'filename': CPU registers, the data space (registers, IO,
+    extended IO and SRAM) up to 'ramEnd', EEPROM, and, if 'withFlash',
+    flash memory.
+
+    If 'ramEnd' is 0, it is taken from the __stack symbol of the ELF
+    file loaded by loadSymbols(), or DEFAULT_RAMEND.  Flash pages
+    identical to that ELF file are left out, as the debugger gets
+    them from there.  IO registers with read side effects are not
+    read, and show up as 0.
+
+    Each memory space is read in blocks of jtag::maxReadSize() bytes.
+    The transfer rate and the time the target was held stopped are
+    reported to stdout, or the GDB console if 'toGdb'.
+
+    Returns false if the core file could not be written.
+**/
+bool dumpCore(const char *filename, bool withFlash, unsigned long ramEnd,
+	      bool toGdb);
+
+#endif /* INCLUDE_COREDUMP_H */
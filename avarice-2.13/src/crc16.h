@@ -6,12 +6,25 @@
  */
 /* $Id: crc16.h 110 2005-05-27 20:42:13Z joerg_wunsch $ */
 
+#define CRC_INIT 0xFFFF
+
 #if defined(__cplusplus)
 extern "C" {
 #endif
+  /*
+   * Update crc (CRC_INIT for a new message) with length bytes of
+   * message, and return the result.  Long messages can be processed
+   * in pieces by feeding the result back in for the next piece.
+   */
   unsigned short crcsum(const unsigned char* message,
 			unsigned long length,
 			unsigned short crc);
+  /*
+   * Verify that the two bytes at csum are the (LSB first) CRC crc, as
+   * obtained from crcsum().
+   */
+  int crccheck(const unsigned char* csum,
+	       unsigned short crc);
   /*
    * Verify that the last two bytes is a (LSB first) valid CRC of the
    * message.
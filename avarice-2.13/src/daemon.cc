@@ -0,0 +1,310 @@
+/*
+ *	avarice - The "avarice" program.
+ *
+ *	This program is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License Version 2
+ *	as published by the Free Software Foundation.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111, USA.
+ *
+ * This file implements a supervisor for several ICEs started by one
+ * avarice invocation.
+ *
+ * Everything that talks to an ICE works on theJtagICE and blocks until
+ * the ICE answers (or the target stops), so targets are not served
+ * from a single event loop.  Instead, one supervising process reads
+ * the configuration and forks a server per target.  The servers are
+ * not exec()ed: they start out sharing the supervisor's memory, and
+ * each has its own ICE connection and gdb state, so a hung or crashed
+ * target does not affect the others.
+ *
+ * This saves starting and restarting the servers by hand, not
+ * resources: every server is a full avarice, with its own sign-on and,
+ * for USB, its own USB daemon process.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <ctype.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/select.h>
+
+#include "avarice.h"
+#include "daemon.h"
+
+static daemon_target targets[DAEMON_MAX_TARGETS];
+static unsigned int numTargets;
+
+static volatile sig_atomic_t daemonStop;
+
+static void daemonSignal(int sig)
+{
+    if (sig != SIGCHLD)
+	daemonStop = 1;
+}
+
+/** Parse "[<host>:]<port>" into 't'.  Returns false if invalid. **/
+static bool parseAddress(char *spec, daemon_target &t)
+{
+    char *colon = strrchr(spec, ':');
+    char *port = spec, *endptr;
+
+    t.host = "0.0.0.0";		// INADDR_ANY, as for a single target
+    if (colon != NULL)
+    {
+	*colon = '\0';
+	if (*spec != '\0')
+	    t.host = spec;
+	port = colon + 1;
+    }
+
+    long n = strtol(port, &endptr, 0);
+    if (*port == '\0' || *endptr != '\0' || n < 1024 || n > 0xffff)
+	return false;
+    t.port = n;
+
+    return true;
+}
+
+bool daemonReadConfig(const char *filename)
+{
+    FILE *f = fopen(filename, "r");
+    char line[512];
+    unsigned int lineno = 0;
+    bool ok = true;
+
+    if (f == NULL)
+    {
+	fprintf(stderr, "Cannot open %s: %s\n", filename, strerror(errno));
+	return false;
+    }
+
+    while (fgets(line, sizeof line, f) != NULL)
+    {
+	char *fields[4];
+	unsigned int n = 0;
+	char *p = line;
+
+	lineno++;
+	while (n < 4)
+	{
+	    while (isspace((unsigned char)*p))
+		p++;
+	    if (*p == '\0' || *p == '#')
+		break;
+	    fields[n++] = p;
+	    while (*p != '\0' && !isspace((unsigned char)*p))
+		p++;
+	    if (*p != '\0')
+		*p++ = '\0';
+	}
+	if (n == 0)
+	    continue;
+
+	if (n < 2 || n > 3)
+	{
+	    fprintf(stderr, "%s:%u: expected [<host>:]<port> <jtag device> "
+		    "[<part>]\n", filename, lineno);
+	    ok = false;
+	    continue;
+	}
+	if (numTargets == DAEMON_MAX_TARGETS)
+	{
+	    fprintf(stderr, "%s:%u: too many targets (max. %d)\n",
+		    filename, lineno, DAEMON_MAX_TARGETS);
+	    ok = false;
+	    break;
+	}
+
+	// The fields live on in the targets.
+	for (unsigned int i = 0; i < n; i++)
+	    fields[i] = strdup(fields[i]);
+
+	daemon_target &t = targets[numTargets];
+	if (!parseAddress(fields[0], t))
+	{
+	    fprintf(stderr, "%s:%u: invalid port (must be >= 1024 and "
+		    "<= 65535)\n", filename, lineno);
+	    ok = false;
+	    continue;
+	}
+	for (unsigned int i = 0; i < numTargets; i++)
+	    if (targets[i].port == t.port)
+	    {
+		fprintf(stderr, "%s:%u: port %d is used twice\n",
+			filename, lineno, t.port);
+		ok = false;
+	    }
+	t.jtagDevice = fields[1];
+	t.part = n > 2? fields[2]: NULL;
+	t.pid = 0;
+	t.started = t.restartAt = 0;
+	numTargets++;
+    }
+    fclose(f);
+
+    if (ok && numTargets == 0)
+    {
+	fprintf(stderr, "%s: no targets configured\n", filename);
+	ok = false;
+    }
+
+    return ok;
+}
+
+/** Start the server for 't'.  Returns true in the server process. **/
+static bool startServer(daemon_target &t, const sigset_t &oldmask)
+{
+    // Don't let the server inherit (and later repeat) buffered output.
+    fflush(stdout);
+    fflush(stderr);
+
+    pid_t pid = fork();
+
+    if (pid < 0)
+    {
+	fprintf(stderr, "Cannot start server for port %d: %s\n",
+		t.port, strerror(errno));
+	t.restartAt = getTimeUsec() + DAEMON_RESTART_DELAY;
+	return false;
+    }
+    if (pid == 0)
+    {
+	signal(SIGCHLD, SIG_DFL);
+	signal(SIGINT, SIG_DFL);
+	signal(SIGTERM, SIG_DFL);
+	sigprocmask(SIG_SETMASK, &oldmask, NULL);
+	return true;
+    }
+
+    t.pid = pid;
+    t.started = getTimeUsec();
+    statusOut("Started server for %s on port %d (pid %d).\n",
+	      t.jtagDevice, t.port, (int)pid);
+    return false;
+}
+
+static void reapServers(void)
+{
+    pid_t pid;
+    int status;
+
+    while ((pid = waitpid(-1, &status, WNOHANG)) > 0)
+	for (unsigned int i = 0; i < numTargets; i++)
+	{
+	    daemon_target &t = targets[i];
+
+	    if (t.pid != pid)
+		continue;
+
+	    unsigned long long now = getTimeUsec();
+	    t.pid = 0;
+	    t.restartAt = now - t.started < DAEMON_MIN_UPTIME?
+		now + DAEMON_RESTART_DELAY: now;
+	    if (WIFSIGNALED(status))
+		statusOut("Server for port %d killed by signal %d.\n",
+			  t.port, WTERMSIG(status));
+	    else
+		statusOut("Server for port %d exited with status %d.\n",
+			  t.port, WEXITSTATUS(status));
+	}
+}
+
+static void stopServers(void)
+{
+    unsigned int i;
+
+    for (i = 0; i < numTargets; i++)
+	if (targets[i].pid != 0)
+	    kill(targets[i].pid, SIGTERM);
+    for (i = 0; i < numTargets; i++)
+	if (targets[i].pid != 0)
+	    waitpid(targets[i].pid, NULL, 0);
+}
+
+const daemon_target *daemonRun(bool detach)
+{
+    struct sigaction sa;
+    sigset_t mask, oldmask;
+
+    if (detach)
+    {
+	pid_t child = fork();
+
+	if (child < 0)
+	{
+	    fprintf(stderr, "Failed to fork");
+	    exit(1);
+	}
+	if (child != 0)
+	    _exit(0);
+	if (setsid() < 0)
+	{
+	    fprintf(stderr, "setsid failed - weird bug");
+	    exit(1);
+	}
+    }
+
+    // Signals are only taken while waiting in pselect(), so none can
+    // slip in between reaping and going to sleep.
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGCHLD);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    sigprocmask(SIG_BLOCK, &mask, &oldmask);
+
+    memset(&sa, 0, sizeof sa);
+    sa.sa_handler = daemonSignal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGCHLD, &sa, NULL);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    statusOut("Serving %u targets.\n", numTargets);
+
+    while (!daemonStop)
+    {
+	reapServers();
+
+	unsigned long long now = getTimeUsec(), next = 0;
+
+	for (unsigned int i = 0; i < numTargets; i++)
+	{
+	    daemon_target &t = targets[i];
+
+	    if (t.pid != 0)
+		continue;
+	    if (t.restartAt <= now && startServer(t, oldmask))
+		return &t;
+	    if (t.pid == 0 && (next == 0 || t.restartAt < next))
+		next = t.restartAt;
+	}
+
+	struct timespec ts, *timeout = NULL;
+	if (next != 0)
+	{
+	    unsigned long long delay = next > now? next - now: 0;
+
+	    ts.tv_sec = delay / 1000000;
+	    ts.tv_nsec = delay % 1000000 * 1000;
+	    timeout = &ts;
+	}
+	pselect(0, NULL, NULL, NULL, timeout, &oldmask);
+    }
+
+    statusOut("Stopping servers.\n");
+    stopServers();
+    exit(0);
+}
@@ -0,0 +1,69 @@
+/*
+ *	avarice - The "avarice" program.
+ *
+ *	This program is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License Version 2
+ *	as published by the Free Software Foundation.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111, USA.
+ *
+ * Interface definition for the multi-target supervisor (daemon.cc).
+ *
+ * The configuration file has one line per target:
+ *
+ *   [<host>:]<port>  <jtag device>  [<part>]
+ *
+ * where <jtag device> is what --jtag accepts (a tty, "usb", or
+ * "usb:<serial>").  Empty lines and lines starting with '#' are
+ * ignored.
+ */
+
+#ifndef INCLUDE_DAEMON_H
+#define INCLUDE_DAEMON_H
+
+#include <sys/types.h>
+
+enum
+{
+    DAEMON_MAX_TARGETS	= 64,
+    // A server that exits within DAEMON_MIN_UPTIME us of being started
+    // is restarted only after DAEMON_RESTART_DELAY us, so a missing
+    // ICE does not make us spin.
+    DAEMON_MIN_UPTIME	= 5000000,
+    DAEMON_RESTART_DELAY = 5000000,
+};
+
+struct daemon_target
+{
+    const char *host;		// address to listen on
+    int port;
+    const char *jtagDevice;
+    char *part;			// NULL to autodetect
+    pid_t pid;			// 0 if not running
+    unsigned long long started;	// getTimeUsec() of the last start
+    unsigned long long restartAt; // when to start again, if not running
+};
+
+/** Read the daemon configuration file 'filename'.  Returns false
+    (after printing a diagnostic to stderr) if it cannot be read or
+    has errors.
+**/
+bool daemonReadConfig(const char *filename);
+
+/** Supervise the configured targets.  A server process is forked for
+    each target, and restarted whenever it exits (e.g. because its ICE
+    went away).  Servers return the target they are to serve; the
+    supervising process only returns from here by exiting, after
+    SIGINT or SIGTERM.  If 'detach' is set, the supervisor first
+    detaches from the terminal.
+**/
+const daemon_target *daemonRun(bool detach);
+
+#endif /* INCLUDE_DAEMON_H */
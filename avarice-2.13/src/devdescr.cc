@@ -18,12 +18,15 @@
  *	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111, USA.
  *
  * This file contains the JTAG ICE device descriptors of all supported
- * MCU types for both, the mkI and mkII protocol.
+ * MCU types for both, the mkI and mkII protocol, and looks devices up
+ * by name or ID.
  *
  * $Id: devdescr.cc 307 2012-11-05 16:11:05Z joerg_wunsch $
  */
 
 #include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
 
 #include "avarice.h"
 #include "jtag.h"
@@ -35,6 +38,464 @@
 // This is a sparse table:
 PRAGMA_DIAG_IGNORED("-Wmissing-field-initializers")
 
+// Devices supported by the JTAG ICE mkI; all others are flagged
+// DEVFL_MKII_ONLY, and have no mkI descriptor.
+
+static jtag1_device_desc_type atmega16_jtag1_desc =
+{
+    JTAG_C_SET_DEVICE_DESCRIPTOR,
+    { 0xCF, 0xAF, 0xFF, 0xFF, 0xFE, 0xFF, 0xFF, 0xFF },
+    { 0x87, 0x26, 0xFF, 0xEF, 0xFE, 0xFF, 0x3F, 0xFA },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x2F, 0x00, 0x00 },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x2F, 0x00, 0x00 },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00 },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00 },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00 },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00 },
+    0x31,
+    0x57,
+    0x00,
+    { 128, 0 },
+    0,
+    { 0x80, 0x1F, 0x00, 0x00 },
+    0,
+    { JTAG_EOM }
+};
+
+static jtag1_device_desc_type atmega162_jtag1_desc =
+{
+    JTAG_C_SET_DEVICE_DESCRIPTOR,
+    { 0xF7, 0x6F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF },
+    { 0xF3, 0x66, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFA }, 
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, 
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, 
+    { 0x02, 0x18, 0x00, 0x30, 0xF3, 0x0F, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+      0x00, 0x00, 0x00, 0x00 },
+    { 0x02, 0x18, 0x00, 0x20, 0xF3, 0x0F, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00 },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+      0x00, 0x00, 0x00, 0x00 },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00 },
+    0x04,
+    0x57,
+    0x00,
+    { 128, 0 },
+    4,
+    { 0x80, 0x1F, 0x00, 0x00 },
+    0x8B,
+    { JTAG_EOM }
+};
+
+static jtag1_device_desc_type atmega169_jtag1_desc =
+{
+    JTAG_C_SET_DEVICE_DESCRIPTOR,
+    { 0xFF, 0xFF, 0xFF, 0xF0, 0xDF, 0x3C, 0xBB, 0xE0 }, 
+    { 0xB6, 0x6D, 0x1B, 0xE0, 0xDF, 0x3C, 0xBA, 0xE0 }, 
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, 
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+    { 0x43, 0xDA, 0x00, 0xFF, 0xF7, 0x0F, 0x00, 0x00,
+      0x00, 0x00, 0x4D, 0x07, 0x37, 0x00, 0x00, 0x00, 
+      0xF0, 0xF0, 0xDE, 0x7B },
+    { 0x43, 0xDA, 0x00, 0xFF, 0xF7, 0x0F, 0x00, 0x00,
+      0x00, 0x00, 0x4D, 0x05, 0x36, 0x00, 0x00, 0x00,
+      0xE0, 0xF0, 0xDE, 0x7B },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+      0x00, 0x00, 0x00, 0x00 },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00 }, 
+    0x31,
+    0x57,
+    0x00,
+    { 128, 0 },
+    4,
+    { 0x80, 0x1F, 0x00, 0x00 },
+    0xFE,
+    { JTAG_EOM }
+};
+
+static jtag1_device_desc_type atmega323_jtag1_desc =
+{
+    JTAG_C_SET_DEVICE_DESCRIPTOR,
+    { 0xCF, 0xAF, 0xFF, 0xFF, 0xFE, 0xFF, 0xFF, 0xFF }, 
+    { 0x87, 0x26, 0xFF, 0xEF, 0xFE, 0xFF, 0x3F, 0xFA }, 
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x2F, 0x00, 0x00 }, 
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x2F, 0x00, 0x00 }, 
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+      0x00, 0x00, 0x00, 0x00 },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00 },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+      0x00, 0x00, 0x00, 0x00 },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00 },
+    0x31,
+    0x57,
+    0x00,
+    { 128, 0 },
+    0,
+    { 0x00, 0x3F, 0x00, 0x00 },
+    0,
+    { JTAG_EOM }
+};
+
+static jtag1_device_desc_type atmega32_jtag1_desc =
+{
+    JTAG_C_SET_DEVICE_DESCRIPTOR,
+    { 0xFF, 0x6F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF }, 
+    { 0xFF, 0x66, 0xFF, 0xFF, 0xFF, 0xFF, 0xBF, 0xFA }, 
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, 
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, 
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+      0x00, 0x00, 0x00, 0x00 },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00 },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+      0x00, 0x00, 0x00, 0x00 },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00 },
+    0x31,
+    0x57,
+    0x00,
+    { 128, 0 },
+    4,
+    { 0x00, 0x3F, 0x00, 0x00 },
+    0,
+    { JTAG_EOM }
+};
+
+static jtag1_device_desc_type atmega64_jtag1_desc =
+{
+    JTAG_C_SET_DEVICE_DESCRIPTOR,
+    { 0xCF, 0x2F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF },
+    { 0xCF, 0x27, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+    { 0x3E, 0xB5, 0x1F, 0x37, 0xFF, 0x1F, 0x21, 0x2F,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00 },
+    { 0x3E, 0xB5, 0x0F, 0x27, 0xFF, 0x1F, 0x21, 0x27,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00 },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00 },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00 },
+    0x22,
+    0x68,
+    0x00,
+    { 0, 1 },
+    8,
+    { 0x00, 0x7E, 0x00, 0x00 },
+    0x9D,
+    { JTAG_EOM }
+};
+
+static jtag1_device_desc_type atmega128_jtag1_desc =
+{
+    JTAG_C_SET_DEVICE_DESCRIPTOR,
+    { 0xCF, 0x2F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF }, 
+    { 0xCF, 0x27, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE }, 
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, 
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, 
+    { 0x3E, 0xB5, 0x1F, 0x37, 0xFF, 0x1F, 0x21, 0x2F,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+      0x00, 0x00, 0x00, 0x00 },
+    { 0x3E, 0xB5, 0x0F, 0x27, 0xFF, 0x1F, 0x21, 0x27,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00 },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+      0x00, 0x00, 0x00, 0x00 },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00 }, 
+    0x22,
+    0x68,
+    0x3B,
+    { 0, 1 },
+    8,
+    { 0x00, 0xFE, 0x00, 0x00 },
+    0x9D,
+    { JTAG_EOM }
+};
+
+static jtag1_device_desc_type at90can128_jtag1_desc =
+{
+    JTAG_C_SET_DEVICE_DESCRIPTOR,
+    { 0xFF, 0xFF, 0xFF, 0xF1, 0xDF, 0x7C, 0xBB, 0xE8 }, 
+    { 0xFF, 0xFF, 0xFF, 0xF1, 0xDF, 0x7C, 0xBB, 0xE8 }, 
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+    { 0x43, 0xC3, 0x33, 0xBF, 0xF7, 0x3F, 0xF7, 0x3F,
+      0x00, 0x00, 0x4D, 0x1F, 0x77, 0x77, 0x00, 0xFF,
+      0xFF, 0xFF, 0xFF, 0x07 },
+    { 0x43, 0xC3, 0x33, 0xBC, 0x77, 0x77, 0xF7, 0x3F,
+      0x00, 0x00, 0x4D, 0x1F, 0x00, 0x00, 0x00, 0xCD,
+      0x3C, 0xF0, 0xFF, 0x04 },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00 },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00 },
+    0x22,
+    0x57,
+    0x3B,
+    { 0, 1 },
+    8,
+    { 0x00, 0xFE, 0x00, 0x00 },
+    0xFA,
+    { JTAG_EOM }
+};
+
+// Xmega devices, for JTAG ICE mkII and AVR Dragon firmware 7 and
+// above.
+
+static xmega_device_desc_type atxmega128a1revd_xmega_desc =
+{
+    CMND_SET_XMEGA_PARAMS, // cmd
+    fill_b2(2),		// whatever
+    47,			// length of following data
+    fill_b4(0x800000),	// NVM offset for application flash
+    fill_b4(0x820000),	// NVM offset for boot flash
+    fill_b4(0x8c0000),	// NVM offset for EEPROM
+    fill_b4(0x8f0020),	// NVM offset for fuses
+    fill_b4(0x8f0027),	// NVM offset for lock bits
+    fill_b4(0x8e0400),	// NVM offset for user signature row
+    fill_b4(0x8e0200),	// NVM offset for production sig. row
+    fill_b4(0x1000000), // NVM offset for data memory
+    fill_b4(131072),	// size of application flash
+    fill_b2(8192),	// size of boot flash
+    fill_b2(512),	// flash page size
+    fill_b2(2048),	// size of EEPROM
+    32,			// EEPROM page size
+    fill_b2(0x1c0),	// IO space base address of NVM controller
+    fill_b2(0x90),	// IO space address of MCU control
+};
+
+static xmega_device_desc_type atxmega128a1_xmega_desc =
+{
+    CMND_SET_XMEGA_PARAMS, // cmd
+    fill_b2(2),		// whatever
+    47,			// length of following data
+    fill_b4(0x800000),	// NVM offset for application flash
+    fill_b4(0x820000),	// NVM offset for boot flash
+    fill_b4(0x8c0000),	// NVM offset for EEPROM
+    fill_b4(0x8f0020),	// NVM offset for fuses
+    fill_b4(0x8f0027),	// NVM offset for lock bits
+    fill_b4(0x8e0400),	// NVM offset for user signature row
+    fill_b4(0x8e0200),	// NVM offset for production sig. row
+    fill_b4(0x1000000), // NVM offset for data memory
+    fill_b4(131072),	// size of application flash
+    fill_b2(8192),	// size of boot flash
+    fill_b2(512),	// flash page size
+    fill_b2(2048),	// size of EEPROM
+    32,			// EEPROM page size
+    fill_b2(0x1c0),	// IO space base address of NVM controller
+    fill_b2(0x90),	// IO space address of MCU control
+};
+
+static xmega_device_desc_type atxmega256a3_xmega_desc =
+{
+    CMND_SET_XMEGA_PARAMS, // cmd
+    fill_b2(2),		// whatever
+    47,			// length of following data
+    fill_b4(0x800000),	// NVM offset for application flash
+    fill_b4(0x840000),	// NVM offset for boot flash
+    fill_b4(0x8c0000),	// NVM offset for EEPROM
+    fill_b4(0x8f0020),	// NVM offset for fuses
+    fill_b4(0x8f0027),	// NVM offset for lock bits
+    fill_b4(0x8e0400),	// NVM offset for user signature row
+    fill_b4(0x8e0200),	// NVM offset for production sig. row
+    fill_b4(0x1000000), // NVM offset for data memory
+    fill_b4(262144),	// size of application flash
+    fill_b2(8192),	// size of boot flash
+    fill_b2(512),	// flash page size
+    fill_b2(4096),	// size of EEPROM
+    32,			// EEPROM page size
+    fill_b2(0x1c0),	// IO space base address of NVM controller
+    fill_b2(0x90),	// IO space address of MCU control
+};
+
+static xmega_device_desc_type atxmega32a4_xmega_desc =
+{
+    CMND_SET_XMEGA_PARAMS, // cmd
+    fill_b2(2),		// whatever
+    47,			// length of following data
+    fill_b4(0x800000),	// NVM offset for application flash
+    fill_b4(0x808000),	// NVM offset for boot flash
+    fill_b4(0x8c0000),	// NVM offset for EEPROM
+    fill_b4(0x8f0020),	// NVM offset for fuses
+    fill_b4(0x8f0027),	// NVM offset for lock bits
+    fill_b4(0x8e0400),	// NVM offset for user signature row
+    fill_b4(0x8e0200),	// NVM offset for production sig. row
+    fill_b4(0x1000000), // NVM offset for data memory
+    fill_b4(32768),	// size of application flash
+    fill_b2(4096),	// size of boot flash
+    fill_b2(256),	// flash page size
+    fill_b2(1024),	// size of EEPROM
+    32,			// EEPROM page size
+    fill_b2(0x1c0),	// IO space base address of NVM controller
+    fill_b2(0x90),	// IO space address of MCU control
+};
+
+static xmega_device_desc_type atxmega128a3_xmega_desc =
+{
+    CMND_SET_XMEGA_PARAMS, // cmd
+    fill_b2(2),		// whatever
+    47,			// length of following data
+    fill_b4(0x800000),	// NVM offset for application flash
+    fill_b4(0x840000),	// NVM offset for boot flash
+    fill_b4(0x8c0000),	// NVM offset for EEPROM
+    fill_b4(0x8f0020),	// NVM offset for fuses
+    fill_b4(0x8f0027),	// NVM offset for lock bits
+    fill_b4(0x8e0400),	// NVM offset for user signature row
+    fill_b4(0x8e0200),	// NVM offset for production sig. row
+    fill_b4(0x1000000), // NVM offset for data memory
+    fill_b4(131072),	// size of application flash
+    fill_b2(8192),	// size of boot flash
+    fill_b2(512),	// flash page size
+    fill_b2(2048),	// size of EEPROM
+    32,			// EEPROM page size
+    fill_b2(0x1c0),	// IO space base address of NVM controller
+    fill_b2(0x90),	// IO space address of MCU control
+};
+
+static xmega_device_desc_type atxmega16d4_xmega_desc =
+{
+    CMND_SET_XMEGA_PARAMS, // cmd
+    fill_b2(2),		// whatever
+    47,			// length of following data
+    fill_b4(0x800000),	// NVM offset for application flash
+    fill_b4(0x804000),	// NVM offset for boot flash
+    fill_b4(0x8c0000),	// NVM offset for EEPROM
+    fill_b4(0x8f0020),	// NVM offset for fuses
+    fill_b4(0x8f0027),	// NVM offset for lock bits
+    fill_b4(0x8e0400),	// NVM offset for user signature row
+    fill_b4(0x8e0200),	// NVM offset for production sig. row
+    fill_b4(0x1000000), // NVM offset for data memory
+    fill_b4(16384),	// size of application flash
+    fill_b2(4096),	// size of boot flash
+    fill_b2(256),	// flash page size
+    fill_b2(1024),	// size of EEPROM
+    32,			// EEPROM page size
+    fill_b2(0x1c0),	// IO space base address of NVM controller
+    fill_b2(0x90),	// IO space address of MCU control
+};
+
+static xmega_device_desc_type atxmega128b1_xmega_desc =
+{
+    CMND_SET_XMEGA_PARAMS, // cmd
+    fill_b2(2),         // whatever
+    47,                 // length of following data
+    fill_b4(0x800000),  // NVM offset for application flash
+    fill_b4(0x820000),  // NVM offset for boot flash
+    fill_b4(0x8c0000),  // NVM offset for EEPROM
+    fill_b4(0x8f0020),  // NVM offset for fuses
+    fill_b4(0x8f0027),  // NVM offset for lock bits
+    fill_b4(0x8e0400),  // NVM offset for user signature row
+    fill_b4(0x8e0200),  // NVM offset for production sig. row
+    fill_b4(0x1000000), // NVM offset for data memory
+    fill_b4(131072),    // size of application flash
+    fill_b2(8192),      // size of boot flash
+    fill_b2(256),       // flash page size
+    fill_b2(2048),      // size of EEPROM
+    32,                 // EEPROM page size
+    fill_b2(0x1c0),     // IO space base address of NVM controller
+    fill_b2(0x90),      // IO space address of MCU control
+};
+
+static xmega_device_desc_type atxmega128b3_xmega_desc =
+{
+    CMND_SET_XMEGA_PARAMS, // cmd
+    fill_b2(2),         // whatever
+    47,                 // length of following data
+    fill_b4(0x800000),  // NVM offset for application flash
+    fill_b4(0x820000),  // NVM offset for boot flash
+    fill_b4(0x8c0000),  // NVM offset for EEPROM
+    fill_b4(0x8f0020),  // NVM offset for fuses
+    fill_b4(0x8f0027),  // NVM offset for lock bits
+    fill_b4(0x8e0400),  // NVM offset for user signature row
+    fill_b4(0x8e0200),  // NVM offset for production sig. row
+    fill_b4(0x1000000), // NVM offset for data memory
+    fill_b4(131072),    // size of application flash
+    fill_b2(8192),      // size of boot flash
+    fill_b2(256),       // flash page size
+    fill_b2(2048),      // size of EEPROM
+    32,                 // EEPROM page size
+    fill_b2(0x1c0),     // IO space base address of NVM controller
+    fill_b2(0x90),      // IO space address of MCU control
+};
+
+static xmega_device_desc_type atxmega64b1_xmega_desc =
+{
+    CMND_SET_XMEGA_PARAMS, // cmd
+    fill_b2(2),         // whatever
+    47,                 // length of following data
+    fill_b4(0x800000),  // NVM offset for application flash
+    fill_b4(0x810000),  // NVM offset for boot flash
+    fill_b4(0x8c0000),  // NVM offset for EEPROM
+    fill_b4(0x8f0020),  // NVM offset for fuses
+    fill_b4(0x8f0027),  // NVM offset for lock bits
+    fill_b4(0x8e0400),  // NVM offset for user signature row
+    fill_b4(0x8e0200),  // NVM offset for production sig. row
+    fill_b4(0x1000000), // NVM offset for data memory
+    fill_b4(65536),    // size of application flash
+    fill_b2(4096),      // size of boot flash
+    fill_b2(256),       // flash page size
+    fill_b2(2048),      // size of EEPROM
+    32,                 // EEPROM page size
+    fill_b2(0x1c0),     // IO space base address of NVM controller
+    fill_b2(0x90),      // IO space address of MCU control
+};
+
+static xmega_device_desc_type atxmega64b3_xmega_desc =
+{
+    CMND_SET_XMEGA_PARAMS, // cmd
+    fill_b2(2),         // whatever
+    47,                 // length of following data
+    fill_b4(0x800000),  // NVM offset for application flash
+    fill_b4(0x810000),  // NVM offset for boot flash
+    fill_b4(0x8c0000),  // NVM offset for EEPROM
+    fill_b4(0x8f0020),  // NVM offset for fuses
+    fill_b4(0x8f0027),  // NVM offset for lock bits
+    fill_b4(0x8e0400),  // NVM offset for user signature row
+    fill_b4(0x8e0200),  // NVM offset for production sig. row
+    fill_b4(0x1000000), // NVM offset for data memory
+    fill_b4(65536),    // size of application flash
+    fill_b2(4096),      // size of boot flash
+    fill_b2(256),       // flash page size
+    fill_b2(2048),      // size of EEPROM
+    32,                 // EEPROM page size
+    fill_b2(0x1c0),     // IO space base address of NVM controller
+    fill_b2(0x90),      // IO space address of MCU control
+};
+
 jtag_device_def_type deviceDefinitions[] = {
     {
 	"atmega16",
@@ -46,33 +507,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega16_io_registers,
 	false,
 	0x03, 0x8000, // fuses
-	{
-	    JTAG_C_SET_DEVICE_DESCRIPTOR,
-	    { 0xCF, 0xAF, 0xFF, 0xFF, 0xFE, 0xFF, 0xFF, 0xFF },
-	    { 0x87, 0x26, 0xFF, 0xEF, 0xFE, 0xFF, 0x3F, 0xFA },
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x2F, 0x00, 0x00 },
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x2F, 0x00, 0x00 },
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00 },
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00 },
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00 },
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00 },
-	    0x31,
-	    0x57,
-	    0x00,
-	    { 128, 0 },
-	    0,
-	    { 0x80, 0x1F, 0x00, 0x00 },
-	    0,
-	    { JTAG_EOM }
-	},
+	&atmega16_jtag1_desc,
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0x6F,0xFF,0xFF,0xFE,0xFF,0xFD,0xFF }, // ucReadIO
@@ -109,7 +544,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,				// ucEindAddress
 	    fill_b2(0x1c),		// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA_162
     {
@@ -122,33 +557,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega162_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	    JTAG_C_SET_DEVICE_DESCRIPTOR,
-	    { 0xF7, 0x6F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF },
-	    { 0xF3, 0x66, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFA }, 
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, 
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, 
-	    { 0x02, 0x18, 0x00, 0x30, 0xF3, 0x0F, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	      0x00, 0x00, 0x00, 0x00 },
-	    { 0x02, 0x18, 0x00, 0x20, 0xF3, 0x0F, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00 },
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	      0x00, 0x00, 0x00, 0x00 },
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00 },
-	    0x04,
-	    0x57,
-	    0x00,
-	    { 128, 0 },
-	    4,
-	    { 0x80, 0x1F, 0x00, 0x00 },
-	    0x8B,
-	    { JTAG_EOM }
-	},
+	&atmega162_jtag1_desc,
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xE7,0x6F,0xFF,0xFF,0xFE,0xFF,0xFF,0xEF }, // ucReadIO
@@ -185,7 +594,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,				// ucEindAddress
 	    fill_b2(0x1c),		// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA_169
     {
@@ -198,33 +607,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega169_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	    JTAG_C_SET_DEVICE_DESCRIPTOR,
-	    { 0xFF, 0xFF, 0xFF, 0xF0, 0xDF, 0x3C, 0xBB, 0xE0 }, 
-	    { 0xB6, 0x6D, 0x1B, 0xE0, 0xDF, 0x3C, 0xBA, 0xE0 }, 
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, 
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
-	    { 0x43, 0xDA, 0x00, 0xFF, 0xF7, 0x0F, 0x00, 0x00,
-	      0x00, 0x00, 0x4D, 0x07, 0x37, 0x00, 0x00, 0x00, 
-	      0xF0, 0xF0, 0xDE, 0x7B },
-	    { 0x43, 0xDA, 0x00, 0xFF, 0xF7, 0x0F, 0x00, 0x00,
-	      0x00, 0x00, 0x4D, 0x05, 0x36, 0x00, 0x00, 0x00,
-	      0xE0, 0xF0, 0xDE, 0x7B },
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	      0x00, 0x00, 0x00, 0x00 },
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00 }, 
-	    0x31,
-	    0x57,
-	    0x00,
-	    { 128, 0 },
-	    4,
-	    { 0x80, 0x1F, 0x00, 0x00 },
-	    0xFE,
-	    { JTAG_EOM }
-	},
+	&atmega169_jtag1_desc,
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xF0,0xDF,0x3C,0xB9,0xE0 }, // ucReadIO
@@ -261,7 +644,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,				// ucEindAddress
 	    fill_b2(0x1f),		// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA_323
     {
@@ -274,33 +657,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega323_io_registers,
 	false,
 	0x03, 0x8000, // fuses
-	{
-	    JTAG_C_SET_DEVICE_DESCRIPTOR,
-	    { 0xCF, 0xAF, 0xFF, 0xFF, 0xFE, 0xFF, 0xFF, 0xFF }, 
-	    { 0x87, 0x26, 0xFF, 0xEF, 0xFE, 0xFF, 0x3F, 0xFA }, 
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x2F, 0x00, 0x00 }, 
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x2F, 0x00, 0x00 }, 
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	      0x00, 0x00, 0x00, 0x00 },
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00 },
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	      0x00, 0x00, 0x00, 0x00 },
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00 },
-	    0x31,
-	    0x57,
-	    0x00,
-	    { 128, 0 },
-	    0,
-	    { 0x00, 0x3F, 0x00, 0x00 },
-	    0,
-	    { JTAG_EOM }
-	},
+	&atmega323_jtag1_desc,
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0x6F,0xFF,0xFF,0xFE,0xFF,0xFD,0xFF }, // ucReadIO
@@ -337,7 +694,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,				// ucEindAddress
 	    fill_b2(0x1c),		// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA_32
     {
@@ -350,33 +707,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega32_io_registers,
 	false,
 	0x03, 0x8000, // fuses
-	{
-	    JTAG_C_SET_DEVICE_DESCRIPTOR,
-	    { 0xFF, 0x6F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF }, 
-	    { 0xFF, 0x66, 0xFF, 0xFF, 0xFF, 0xFF, 0xBF, 0xFA }, 
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, 
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, 
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	      0x00, 0x00, 0x00, 0x00 },
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00 },
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	      0x00, 0x00, 0x00, 0x00 },
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00 },
-	    0x31,
-	    0x57,
-	    0x00,
-	    { 128, 0 },
-	    4,
-	    { 0x00, 0x3F, 0x00, 0x00 },
-	    0,
-	    { JTAG_EOM }
-	},
+	&atmega32_jtag1_desc,
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0x6F,0xFF,0xFF,0xFE,0xFF,0xFD,0xFF }, // ucReadIO
@@ -413,7 +744,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,				// ucEindAddress
 	    fill_b2(0x1c),		// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
 
     // DEV_ATMEGA_64
@@ -427,33 +758,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega64_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	    JTAG_C_SET_DEVICE_DESCRIPTOR,
-	    { 0xCF, 0x2F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF },
-	    { 0xCF, 0x27, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE },
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
-	    { 0x3E, 0xB5, 0x1F, 0x37, 0xFF, 0x1F, 0x21, 0x2F,
-	      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00 },
-	    { 0x3E, 0xB5, 0x0F, 0x27, 0xFF, 0x1F, 0x21, 0x27,
-	      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00 },
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00 },
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00 },
-	    0x22,
-	    0x68,
-	    0x00,
-	    { 0, 1 },
-	    8,
-	    { 0x00, 0x7E, 0x00, 0x00 },
-	    0x9D,
-	    { JTAG_EOM }
-	},
+	&atmega64_jtag1_desc,
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0x6F,0xFF,0xFF,0xFB,0xFF,0xFF,0xF7 }, // ucReadIO
@@ -490,7 +795,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,				// ucEindAddress
 	    fill_b2(0x1c),		// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA_128
     {
@@ -503,33 +808,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega128_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	    JTAG_C_SET_DEVICE_DESCRIPTOR,
-	    { 0xCF, 0x2F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF }, 
-	    { 0xCF, 0x27, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE }, 
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, 
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, 
-	    { 0x3E, 0xB5, 0x1F, 0x37, 0xFF, 0x1F, 0x21, 0x2F,
-	      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	      0x00, 0x00, 0x00, 0x00 },
-	    { 0x3E, 0xB5, 0x0F, 0x27, 0xFF, 0x1F, 0x21, 0x27,
-	      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00 },
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	      0x00, 0x00, 0x00, 0x00 },
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00 }, 
-	    0x22,
-	    0x68,
-	    0x3B,
-	    { 0, 1 },
-	    8,
-	    { 0x00, 0xFE, 0x00, 0x00 },
-	    0x9D,
-	    { JTAG_EOM }
-	},
+	&atmega128_jtag1_desc,
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0x6F,0xFF,0xFF,0xFB,0xFF,0xFF,0xFF }, // ucReadIO
@@ -566,7 +845,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,				// ucEindAddress
 	    fill_b2(0x1c),		// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATCAN_128
     {
@@ -579,33 +858,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	at90can128_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	    JTAG_C_SET_DEVICE_DESCRIPTOR,
-	    { 0xFF, 0xFF, 0xFF, 0xF1, 0xDF, 0x7C, 0xBB, 0xE8 }, 
-	    { 0xFF, 0xFF, 0xFF, 0xF1, 0xDF, 0x7C, 0xBB, 0xE8 }, 
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
-	    { 0x43, 0xC3, 0x33, 0xBF, 0xF7, 0x3F, 0xF7, 0x3F,
-	      0x00, 0x00, 0x4D, 0x1F, 0x77, 0x77, 0x00, 0xFF,
-	      0xFF, 0xFF, 0xFF, 0x07 },
-	    { 0x43, 0xC3, 0x33, 0xBC, 0x77, 0x77, 0xF7, 0x3F,
-	      0x00, 0x00, 0x4D, 0x1F, 0x00, 0x00, 0x00, 0xCD,
-	      0x3C, 0xF0, 0xFF, 0x04 },
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00 },
-	    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	      0x00, 0x00, 0x00, 0x00 },
-	    0x22,
-	    0x57,
-	    0x3B,
-	    { 0, 1 },
-	    8,
-	    { 0x00, 0xFE, 0x00, 0x00 },
-	    0xFA,
-	    { JTAG_EOM }
-	},
+	&at90can128_jtag1_desc,
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xF1,0xDF,0x3C,0xB9,0xE8 }, // ucReadIO
@@ -642,7 +895,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,				// ucEindAddress
 	    fill_b2(0x1f),		// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA164P
     {
@@ -655,9 +908,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega164p_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0x0F,0xE0,0xF8,0xFF,0x3D,0xB9,0xE8 }, // ucReadIO
@@ -702,7 +953,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA324P
     {
@@ -715,9 +966,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega324p_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0x0F,0xE0,0xF8,0xFF,0x3D,0xB9,0xE8 }, // ucReadIO
@@ -762,7 +1011,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA644
     {
@@ -775,9 +1024,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega644_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	  0			// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0x0F,0xE0,0xF8,0xFF,0x3D,0xB9,0xE8 }, // ucReadIO
@@ -814,7 +1061,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,				// ucEindAddress
 	    fill_b2(0x1f),		// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
 
     // DEV_ATMEGA325
@@ -828,9 +1075,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega325_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xF0,0xDF,0x3C,0xB9,0xE0 }, // ucReadIO
@@ -875,7 +1120,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
 
 
@@ -890,9 +1135,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega3250_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xF0,0xDF,0x3C,0xB9,0xE0 }, // ucReadIO
@@ -937,7 +1180,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
 
 
@@ -952,9 +1195,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega645_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xF0,0xDF,0x3C,0xB9,0xE0 }, // ucReadIO
@@ -999,7 +1240,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
 
 
@@ -1014,9 +1255,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega6450_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xF0,0xDF,0x3C,0xB9,0xE0 }, // ucReadIO
@@ -1061,7 +1300,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
 
     // DEV_ATMEGA329
@@ -1075,9 +1314,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega329_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	  0			// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xF0,0xDF,0x3C,0xB9,0xE0 }, // ucReadIO
@@ -1114,7 +1351,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,				// ucEindAddress
 	    fill_b2(0x1f),		// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA3290
     {
@@ -1127,9 +1364,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega3290_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	  0			// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xF0,0xDF,0x3C,0xB9,0xE0 }, // ucReadIO
@@ -1166,7 +1401,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,				// ucEindAddress
 	    fill_b2(0x1f),		// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA649
     {
@@ -1179,9 +1414,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega649_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	  0			// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xF0,0xDF,0x3C,0xB9,0xE0 }, // ucReadIO
@@ -1218,7 +1451,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,				// ucEindAddress
 	    fill_b2(0x1f),		// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA6490
     {
@@ -1231,9 +1464,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega6490_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	  0			// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xF0,0xDF,0x3C,0xB9,0xE0 }, // ucReadIO
@@ -1270,7 +1501,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,				// ucEindAddress
 	    fill_b2(0x1f),		// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA_640
     {
@@ -1283,9 +1514,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega640_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	  0			// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xFF,0xFF,0x3D,0xB9,0xF8 }, // ucReadIO
@@ -1328,7 +1557,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0x3c,			// ucEindAddress
 	    fill_b2(0x1F),		// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA_1280
     {
@@ -1341,9 +1570,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega1280_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	  0			// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xFF,0xFF,0x3D,0xB9,0xF8 }, // ucReadIO
@@ -1386,7 +1613,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0x3c,			// ucEindAddress
 	    fill_b2(0x1F),		// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA_1281
     {
@@ -1399,9 +1626,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega1281_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	  0			// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xF9,0xFF,0x3D,0xB9,0xF8 }, // ucReadIO
@@ -1444,7 +1669,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0x3c,			// ucEindAddress
 	    fill_b2(0x1F),		// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA_2560
     {
@@ -1457,9 +1682,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega2560_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	  0			// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xFF,0xFF,0x3D,0xB9,0xF8 }, // ucReadIO
@@ -1502,7 +1725,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0x3c,			// ucEindAddress
 	    fill_b2(0x1F),		// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA_2561
     {
@@ -1515,9 +1738,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega2561_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	  0			// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xFF,0xFF,0x3D,0xB9,0xF8 }, // ucReadIO
@@ -1560,7 +1781,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0x3c,			// ucEindAddress
 	    fill_b2(0x1F),		// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA48
     {
@@ -1573,9 +1794,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega48_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	  0			// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xF8,0x0F,0xE0,0xF8,0xFB,0x3D,0xB9,0xE0 }, // ucReadIO
@@ -1618,7 +1837,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,				// ucEindAddress
 	    fill_b2(0x1F),		// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA88
     {
@@ -1631,9 +1850,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega88_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xF8,0x0F,0xE0,0xF8,0xFF,0x3D,0xB9,0xE0 }, // ucReadIO
@@ -1680,7 +1897,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA168
     {
@@ -1693,9 +1910,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega168_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xF8,0x0F,0xE0,0xF8,0xFF,0x3D,0xB9,0xE0 }, // ucReadIO
@@ -1742,7 +1957,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATTINY13
     {
@@ -1755,9 +1970,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	attiny13_io_registers,
 	false,
 	0x03, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xF8,0x01,0xF0,0x71,0x42,0x83,0xFE,0xAF }, // ucReadIO
@@ -1804,7 +2017,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1C),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATTINY2313
     {
@@ -1817,9 +2030,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	attiny2313_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0x0E,0xEF,0xFF,0x7F,0x3F,0xFF,0x7F,0xBF }, // ucReadIO
@@ -1866,7 +2077,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1C),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATTINY4313
     {
@@ -1879,9 +2090,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	NULL,	// registers not yet defined
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0x0E,0xEF,0xFF,0x7F,0x3F,0xFF,0x7F,0xFF }, // ucReadIO
@@ -1940,9 +2149,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	at90pwm2_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xF8,0x7F,0x60,0xFE,0xFF,0x33,0xBD,0xE0 }, // ucReadIO
@@ -1989,7 +2196,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_AT90PWM3
     {
@@ -2002,9 +2209,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	at90pwm3_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xF8,0x7F,0x60,0xFE,0xFF,0x33,0xBD,0xE0 }, // ucReadIO
@@ -2051,7 +2256,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_AT90PWM2B
     {
@@ -2064,9 +2269,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	at90pwm2b_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xF8,0x7F,0x60,0xFE,0xFF,0x33,0xBD,0xE0 }, // ucReadIO
@@ -2113,7 +2316,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_AT90PWM3B
     {
@@ -2126,9 +2329,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	at90pwm3b_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xF8,0x7F,0x60,0xFE,0xFF,0x33,0xBD,0xE0 }, // ucReadIO
@@ -2175,7 +2376,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA16M1
     {
@@ -2188,9 +2389,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	NULL,	// registers not yet defined
 	false,
 	0x00, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xF8,0x7F,0x60,0xF6,0xFF,0x33,0xB9,0xE0 }, // ucReadIO
@@ -2237,7 +2436,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },		// Xmega device descr.
+	NULL,		// Xmega device descr.
     },
     // DEV_ATMEGA32M1
     {
@@ -2247,12 +2446,10 @@ jtag_device_def_type deviceDefinitions[] = {
 	4, 256,	// 1024 bytes EEPROM
 	31 * 4,	// 31 interrupt vectors
 	DEVFL_MKII_ONLY,
-	NULL,	// registers not yet defined
 	atmega32m1_io_registers,
+	false,
 	0x00, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xF8,0x7F,0x60,0xF6,0xFF,0x33,0xB9,0xE0 }, // ucReadIO
@@ -2299,7 +2496,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },		// Xmega device descr.
+	NULL,		// Xmega device descr.
     },
     // DEV_ATMEGA64M1
     {
@@ -2312,9 +2509,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	NULL,	// registers not yet defined
 	false,
 	0x00, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xF8,0x7F,0x60,0xF6,0xFF,0x33,0xB9,0xE0 }, // ucReadIO
@@ -2361,7 +2556,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },		// Xmega device descr.
+	NULL,		// Xmega device descr.
     },
     // DEV_ATMEGA32C1
     {
@@ -2371,12 +2566,10 @@ jtag_device_def_type deviceDefinitions[] = {
 	4, 256,	// 1024 bytes EEPROM
 	31 * 4,	// 31 interrupt vectors
 	DEVFL_MKII_ONLY,
-	NULL,	// registers not yet defined
 	atmega32c1_io_registers,
+	false,
 	0x00, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xF8,0x7F,0x60,0xF6,0xFF,0x33,0xB9,0xE0 }, // ucReadIO
@@ -2423,7 +2616,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },		// Xmega device descr.
+	NULL,		// Xmega device descr.
     },
     // DEV_ATMEGA64C1
     {
@@ -2436,9 +2629,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	NULL,	// registers not yet defined
 	false,
 	0x00, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xF8,0x7F,0x60,0xF6,0xFF,0x33,0xB9,0xE0 }, // ucReadIO
@@ -2485,7 +2676,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },		// Xmega device descr.
+	NULL,		// Xmega device descr.
     },
     // DEV_ATTINY24
     {
@@ -2498,9 +2689,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	attiny24_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFB,0xF9,0xFD,0xFF,0x7F,0xFF,0xFF,0xFF }, // ucReadIO
@@ -2547,7 +2736,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1C),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATTINY44
     {
@@ -2560,9 +2749,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	attiny44_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFB,0xF9,0xFD,0xFF,0x7F,0xFF,0xFF,0xFF }, // ucReadIO
@@ -2609,7 +2796,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1C),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATTINY84
     {
@@ -2622,9 +2809,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	attiny84_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFB,0xF9,0xFD,0xFF,0x7F,0xFF,0xFF,0xFF }, // ucReadIO
@@ -2671,7 +2856,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1C),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATTINY25
     {
@@ -2684,9 +2869,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	attiny25_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xF8,0xE1,0xFF,0xF1,0xFB,0xFF,0xBF,0xAF }, // ucReadIO
@@ -2733,7 +2916,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1C),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATTINY45
     {
@@ -2746,9 +2929,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	attiny45_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xF8,0xE1,0xFF,0xF1,0xFB,0xFF,0xBF,0xEF }, // ucReadIO
@@ -2795,7 +2976,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1C),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATTINY85
     {
@@ -2808,9 +2989,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	attiny85_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xF8,0xE1,0xFF,0xF1,0xFB,0xFF,0xBF,0xEF }, // ucReadIO
@@ -2857,7 +3036,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1C),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATTINY261
     {
@@ -2870,9 +3049,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	attiny261_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xFF,0xFE,0xFB,0xFF,0xEF }, // ucReadIO
@@ -2919,7 +3096,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1C),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATTINY461
     {
@@ -2932,9 +3109,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	attiny461_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xFF,0xFE,0xFB,0xFF,0xEF }, // ucReadIO
@@ -2981,7 +3156,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1C),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATTINY861
     {
@@ -2994,9 +3169,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	attiny861_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xFF,0xFE,0xFB,0xFF,0xEF }, // ucReadIO
@@ -3043,7 +3216,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1C),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_AT90CAN32
     {
@@ -3056,9 +3229,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	at90can32_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xF1,0xDF,0x3C,0xB9,0xE8 }, // ucReadIO
@@ -3103,7 +3274,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_AT90CAN64
     {
@@ -3116,9 +3287,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	at90can64_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xF1,0xDF,0x3C,0xB9,0xE8 }, // ucReadIO
@@ -3163,7 +3332,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_AT90PWM216
     {
@@ -3176,9 +3345,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	at90pwm216_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xF8,0x7F,0x60,0xFE,0xFF,0x33,0xB9,0xE0 }, // ucReadIO
@@ -3225,7 +3392,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_AT90PWM316
     {
@@ -3238,9 +3405,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	at90pwm316_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xF8,0x7F,0x60,0xFE,0xFF,0x33,0xB9,0xE0 }, // ucReadIO
@@ -3287,7 +3452,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_AT90USB1287
     {
@@ -3300,9 +3465,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	at90usb1287_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xE3,0xF9,0xFF,0x3F,0xB9,0xF8 }, // ucReadIO
@@ -3347,7 +3510,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0x3C,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_AT90USB162
     {
@@ -3360,9 +3523,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	at90usb162_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xF8,0x0F,0x60,0xF8,0xFF,0x3F,0xB9,0xF0 }, // ucReadIO
@@ -3409,7 +3570,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0x3C,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_AT90USB646
     {
@@ -3422,9 +3583,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	at90usb646_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xE3,0xF9,0xFF,0x3F,0xB9,0xF8 }, // ucReadIO
@@ -3469,7 +3628,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0x3C,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_AT90USB647
     {
@@ -3482,9 +3641,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	at90usb647_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xE3,0xF9,0xFF,0x3F,0xB9,0xF8 }, // ucReadIO
@@ -3529,7 +3686,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0x3C,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA1284P
     {
@@ -3542,9 +3699,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega1284p_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0x0F,0xE0,0xF9,0xFF,0x3D,0xB9,0xE8 }, // ucReadIO
@@ -3589,7 +3744,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA165
     {
@@ -3602,9 +3757,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega165_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xF0,0xDF,0x3C,0xB9,0xE0 }, // ucReadIO
@@ -3649,7 +3802,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA165P
     {
@@ -3662,9 +3815,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega165p_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xF0,0xDF,0x3C,0xB9,0xE0 }, // ucReadIO
@@ -3709,7 +3860,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA168P
     {
@@ -3722,9 +3873,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega168p_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xF8,0x0F,0xE0,0xF8,0xFF,0x3D,0xB9,0xE0 }, // ucReadIO
@@ -3771,7 +3920,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA16HVA
     {
@@ -3784,9 +3933,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega16hva_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0x7F,0x01,0xE0,0xF0,0xFB,0x3F,0xB8,0xE0 }, // ucReadIO
@@ -3833,7 +3980,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA3250P
     {
@@ -3846,9 +3993,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega3250p_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xF0,0xDF,0x3C,0xB9,0xE0 }, // ucReadIO
@@ -3893,7 +4038,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA325P
     {
@@ -3906,9 +4051,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega325p_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xF0,0xDF,0x3C,0xB9,0xE0 }, // ucReadIO
@@ -3953,7 +4096,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA328P
     {
@@ -3966,9 +4109,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega328p_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xF8,0x0F,0xE0,0xF8,0xFF,0x3D,0xB9,0xE0 }, // ucReadIO
@@ -4015,7 +4156,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA3290P
     {
@@ -4028,9 +4169,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega3290p_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xF0,0xDF,0x3C,0xB9,0xE0 }, // ucReadIO
@@ -4075,7 +4214,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA329P
     {
@@ -4088,9 +4227,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega329p_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xF0,0xDF,0x3C,0xB9,0xE0 }, // ucReadIO
@@ -4135,7 +4272,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA32HVB
     {
@@ -4148,9 +4285,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega32hvb_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0x7F,0x01,0xE0,0xF8,0xFF,0x3F,0xB8,0xE0 }, // ucReadIO
@@ -4197,7 +4332,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA32U4
     {
@@ -4210,9 +4345,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega32u4_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xF8,0xFF,0xE3,0xFB,0xFF,0x3F,0xBD,0xF8 }, // ucReadIO
@@ -4257,7 +4390,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0x3C,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA406
     {
@@ -4270,9 +4403,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega406_io_registers,
 	false,
 	0x07, 0x0200, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0x3F,0x0F,0x60,0xF8,0xFF,0x0D,0xB8,0xE0 }, // ucReadIO
@@ -4317,7 +4448,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA48P
     {
@@ -4330,9 +4461,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega48p_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xF8,0x0F,0xE0,0xF8,0xFB,0x3D,0xB9,0xE0 }, // ucReadIO
@@ -4379,7 +4508,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA644P
     {
@@ -4392,9 +4521,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega644p_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0x0F,0xE0,0xF8,0xFF,0x3D,0xB9,0xE8 }, // ucReadIO
@@ -4439,7 +4566,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATMEGA88P
     {
@@ -4452,9 +4579,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega88p_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xF8,0x0F,0xE0,0xF8,0xFF,0x3D,0xB9,0xE0 }, // ucReadIO
@@ -4501,7 +4626,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATTINY167
     {
@@ -4514,9 +4639,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	attiny167_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0x3F,0x00,0x64,0xF8,0xEF,0x3D,0xB9,0xE0 }, // ucReadIO
@@ -4561,7 +4684,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATTINY43U
     {
@@ -4574,9 +4697,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	attiny43u_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFB,0xF9,0xFD,0x7F,0x4B,0xF8,0xFF,0xFF }, // ucReadIO
@@ -4623,7 +4744,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1C),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATTINY48
     {
@@ -4636,9 +4757,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	attiny48_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xF8,0x7F,0x64,0xF8,0xEB,0x3D,0xB9,0xA0 }, // ucReadIO
@@ -4685,7 +4804,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATTINY88
     {
@@ -4698,9 +4817,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	attiny88_io_registers,
 	false,
 	0x07, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xF8,0x7F,0x64,0xF8,0xEB,0x3D,0xB9,0xA0 }, // ucReadIO
@@ -4747,7 +4864,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATXMEGA128A1 revision D
     {
@@ -4760,9 +4877,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	NULL,	// registers not yet defined
 	true,
 	0x37, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xF9,0xFF,0x3D,0xB9,0xF8 }, // ucReadIO
@@ -4809,26 +4924,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0),	// EECRAddress
 	},
-	{
-	    CMND_SET_XMEGA_PARAMS, // cmd
-	    fill_b2(2),		// whatever
-	    47,			// length of following data
-	    fill_b4(0x800000),	// NVM offset for application flash
-	    fill_b4(0x820000),	// NVM offset for boot flash
-	    fill_b4(0x8c0000),	// NVM offset for EEPROM
-	    fill_b4(0x8f0020),	// NVM offset for fuses
-	    fill_b4(0x8f0027),	// NVM offset for lock bits
-	    fill_b4(0x8e0400),	// NVM offset for user signature row
-	    fill_b4(0x8e0200),	// NVM offset for production sig. row
-	    fill_b4(0x1000000), // NVM offset for data memory
-	    fill_b4(131072),	// size of application flash
-	    fill_b2(8192),	// size of boot flash
-	    fill_b2(512),	// flash page size
-	    fill_b2(2048),	// size of EEPROM
-	    32,			// EEPROM page size
-	    fill_b2(0x1c0),	// IO space base address of NVM controller
-	    fill_b2(0x90),	// IO space address of MCU control
-	},
+	&atxmega128a1revd_xmega_desc,
     },
     // DEV_ATXMEGA128A1 revision G (and newer)
     {
@@ -4841,9 +4937,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	NULL,	// registers not yet defined
 	true,
 	0x37, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xF9,0xFF,0x3D,0xB9,0xF8 }, // ucReadIO
@@ -4890,26 +4984,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0),	// EECRAddress
 	},
-	{
-	    CMND_SET_XMEGA_PARAMS, // cmd
-	    fill_b2(2),		// whatever
-	    47,			// length of following data
-	    fill_b4(0x800000),	// NVM offset for application flash
-	    fill_b4(0x820000),	// NVM offset for boot flash
-	    fill_b4(0x8c0000),	// NVM offset for EEPROM
-	    fill_b4(0x8f0020),	// NVM offset for fuses
-	    fill_b4(0x8f0027),	// NVM offset for lock bits
-	    fill_b4(0x8e0400),	// NVM offset for user signature row
-	    fill_b4(0x8e0200),	// NVM offset for production sig. row
-	    fill_b4(0x1000000), // NVM offset for data memory
-	    fill_b4(131072),	// size of application flash
-	    fill_b2(8192),	// size of boot flash
-	    fill_b2(512),	// flash page size
-	    fill_b2(2048),	// size of EEPROM
-	    32,			// EEPROM page size
-	    fill_b2(0x1c0),	// IO space base address of NVM controller
-	    fill_b2(0x90),	// IO space address of MCU control
-	},
+	&atxmega128a1_xmega_desc,
     },
     // DEV_ATXMEGA256A3
     {
@@ -4922,9 +4997,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	NULL,	// registers not yet defined
 	true,
 	0x37, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xF9,0xFF,0x3D,0xB9,0xF8 }, // ucReadIO
@@ -4971,26 +5044,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0),	// EECRAddress
 	},
-	{
-	    CMND_SET_XMEGA_PARAMS, // cmd
-	    fill_b2(2),		// whatever
-	    47,			// length of following data
-	    fill_b4(0x800000),	// NVM offset for application flash
-	    fill_b4(0x840000),	// NVM offset for boot flash
-	    fill_b4(0x8c0000),	// NVM offset for EEPROM
-	    fill_b4(0x8f0020),	// NVM offset for fuses
-	    fill_b4(0x8f0027),	// NVM offset for lock bits
-	    fill_b4(0x8e0400),	// NVM offset for user signature row
-	    fill_b4(0x8e0200),	// NVM offset for production sig. row
-	    fill_b4(0x1000000), // NVM offset for data memory
-	    fill_b4(262144),	// size of application flash
-	    fill_b2(8192),	// size of boot flash
-	    fill_b2(512),	// flash page size
-	    fill_b2(4096),	// size of EEPROM
-	    32,			// EEPROM page size
-	    fill_b2(0x1c0),	// IO space base address of NVM controller
-	    fill_b2(0x90),	// IO space address of MCU control
-	},
+	&atxmega256a3_xmega_desc,
     },
     // DEV_ATXMEGA32A4
     {
@@ -5003,9 +5057,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	NULL,	// registers not yet defined
 	true,
 	0x37, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xF9,0xFF,0x3D,0xB9,0xF8 }, // ucReadIO
@@ -5052,26 +5104,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0),	// EECRAddress
 	},
-	{
-	    CMND_SET_XMEGA_PARAMS, // cmd
-	    fill_b2(2),		// whatever
-	    47,			// length of following data
-	    fill_b4(0x800000),	// NVM offset for application flash
-	    fill_b4(0x808000),	// NVM offset for boot flash
-	    fill_b4(0x8c0000),	// NVM offset for EEPROM
-	    fill_b4(0x8f0020),	// NVM offset for fuses
-	    fill_b4(0x8f0027),	// NVM offset for lock bits
-	    fill_b4(0x8e0400),	// NVM offset for user signature row
-	    fill_b4(0x8e0200),	// NVM offset for production sig. row
-	    fill_b4(0x1000000), // NVM offset for data memory
-	    fill_b4(32768),	// size of application flash
-	    fill_b2(4096),	// size of boot flash
-	    fill_b2(256),	// flash page size
-	    fill_b2(1024),	// size of EEPROM
-	    32,			// EEPROM page size
-	    fill_b2(0x1c0),	// IO space base address of NVM controller
-	    fill_b2(0x90),	// IO space address of MCU control
-	},
+	&atxmega32a4_xmega_desc,
     },
     // DEV_ATXMEGA128A3
     {
@@ -5084,9 +5117,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	NULL,	// registers not yet defined
 	true,
 	0x37, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xF9,0xFF,0x3D,0xB9,0xF8 }, // ucReadIO
@@ -5133,26 +5164,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0),	// EECRAddress
 	},
-	{
-	    CMND_SET_XMEGA_PARAMS, // cmd
-	    fill_b2(2),		// whatever
-	    47,			// length of following data
-	    fill_b4(0x800000),	// NVM offset for application flash
-	    fill_b4(0x840000),	// NVM offset for boot flash
-	    fill_b4(0x8c0000),	// NVM offset for EEPROM
-	    fill_b4(0x8f0020),	// NVM offset for fuses
-	    fill_b4(0x8f0027),	// NVM offset for lock bits
-	    fill_b4(0x8e0400),	// NVM offset for user signature row
-	    fill_b4(0x8e0200),	// NVM offset for production sig. row
-	    fill_b4(0x1000000), // NVM offset for data memory
-	    fill_b4(131072),	// size of application flash
-	    fill_b2(8192),	// size of boot flash
-	    fill_b2(512),	// flash page size
-	    fill_b2(2048),	// size of EEPROM
-	    32,			// EEPROM page size
-	    fill_b2(0x1c0),	// IO space base address of NVM controller
-	    fill_b2(0x90),	// IO space address of MCU control
-	},
+	&atxmega128a3_xmega_desc,
     },
     // DEV_ATXMEGA16D4
     {
@@ -5165,9 +5177,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	NULL,	// registers not yet defined
 	true,
 	0x37, 0x0000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xF9,0xFF,0x3D,0xB9,0xF8 }, // ucReadIO
@@ -5214,26 +5224,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0,	// ucEindAddress
 	    fill_b2(0),	// EECRAddress
 	},
-	{
-	    CMND_SET_XMEGA_PARAMS, // cmd
-	    fill_b2(2),		// whatever
-	    47,			// length of following data
-	    fill_b4(0x800000),	// NVM offset for application flash
-	    fill_b4(0x804000),	// NVM offset for boot flash
-	    fill_b4(0x8c0000),	// NVM offset for EEPROM
-	    fill_b4(0x8f0020),	// NVM offset for fuses
-	    fill_b4(0x8f0027),	// NVM offset for lock bits
-	    fill_b4(0x8e0400),	// NVM offset for user signature row
-	    fill_b4(0x8e0200),	// NVM offset for production sig. row
-	    fill_b4(0x1000000), // NVM offset for data memory
-	    fill_b4(16384),	// size of application flash
-	    fill_b2(4096),	// size of boot flash
-	    fill_b2(256),	// flash page size
-	    fill_b2(1024),	// size of EEPROM
-	    32,			// EEPROM page size
-	    fill_b2(0x1c0),	// IO space base address of NVM controller
-	    fill_b2(0x90),	// IO space address of MCU control
-	},
+	&atxmega16d4_xmega_desc,
     },
     // DEV_ATMEGA128RFA1
     {
@@ -5246,9 +5237,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	atmega128rfa1_io_registers,
 	false,
 	0x07, 0x8000, // fuses
-	{
-	    0	// no mkI support
-	},
+	NULL,			// no mkI support
 	{
 	    CMND_SET_DEVICE_DESCRIPTOR,
 	    { 0xFF,0xFF,0xFF,0xF9,0xFF,0x3D,0xB9,0xF8 }, // ucReadIO
@@ -5301,7 +5290,7 @@ jtag_device_def_type deviceDefinitions[] = {
 	    0x3C,	// ucEindAddress
 	    fill_b2(0x1F),	// EECRAddress
 	},
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     },
     // DEV_ATXMEGA128B1
     {
@@ -5314,9 +5303,7 @@ jtag_device_def_type deviceDefinitions[] = {
         NULL,   // registers not yet defined
         true,
         0x37, 0x0000, // fuses
-        {
-            0   // no mkI support
-        },
+        NULL,			// no mkI support
         {
             CMND_SET_DEVICE_DESCRIPTOR,
             { 0xFF,0xFF,0xFF,0xF9,0xFF,0x3D,0xB9,0xF8 }, // ucReadIO
@@ -5363,26 +5350,7 @@ jtag_device_def_type deviceDefinitions[] = {
             0,  // ucEindAddress
             fill_b2(0), // EECRAddress
         },
-        {
-            CMND_SET_XMEGA_PARAMS, // cmd
-            fill_b2(2),         // whatever
-            47,                 // length of following data
-            fill_b4(0x800000),  // NVM offset for application flash
-            fill_b4(0x820000),  // NVM offset for boot flash
-            fill_b4(0x8c0000),  // NVM offset for EEPROM
-            fill_b4(0x8f0020),  // NVM offset for fuses
-            fill_b4(0x8f0027),  // NVM offset for lock bits
-            fill_b4(0x8e0400),  // NVM offset for user signature row
-            fill_b4(0x8e0200),  // NVM offset for production sig. row
-            fill_b4(0x1000000), // NVM offset for data memory
-            fill_b4(131072),    // size of application flash
-            fill_b2(8192),      // size of boot flash
-            fill_b2(256),       // flash page size
-            fill_b2(2048),      // size of EEPROM
-            32,                 // EEPROM page size
-            fill_b2(0x1c0),     // IO space base address of NVM controller
-            fill_b2(0x90),      // IO space address of MCU control
-        },
+        &atxmega128b1_xmega_desc,
     },
     // DEV_ATXMEGA128B3
     {
@@ -5395,9 +5363,7 @@ jtag_device_def_type deviceDefinitions[] = {
         NULL,   // registers not yet defined
         true,
         0x37, 0x0000, // fuses
-        {
-            0   // no mkI support
-        },
+        NULL,			// no mkI support
         {
             CMND_SET_DEVICE_DESCRIPTOR,
             { 0xFF,0xFF,0xFF,0xF9,0xFF,0x3D,0xB9,0xF8 }, // ucReadIO
@@ -5444,26 +5410,7 @@ jtag_device_def_type deviceDefinitions[] = {
             0,  // ucEindAddress
             fill_b2(0), // EECRAddress
         },
-        {
-            CMND_SET_XMEGA_PARAMS, // cmd
-            fill_b2(2),         // whatever
-            47,                 // length of following data
-            fill_b4(0x800000),  // NVM offset for application flash
-            fill_b4(0x820000),  // NVM offset for boot flash
-            fill_b4(0x8c0000),  // NVM offset for EEPROM
-            fill_b4(0x8f0020),  // NVM offset for fuses
-            fill_b4(0x8f0027),  // NVM offset for lock bits
-            fill_b4(0x8e0400),  // NVM offset for user signature row
-            fill_b4(0x8e0200),  // NVM offset for production sig. row
-            fill_b4(0x1000000), // NVM offset for data memory
-            fill_b4(131072),    // size of application flash
-            fill_b2(8192),      // size of boot flash
-            fill_b2(256),       // flash page size
-            fill_b2(2048),      // size of EEPROM
-            32,                 // EEPROM page size
-            fill_b2(0x1c0),     // IO space base address of NVM controller
-            fill_b2(0x90),      // IO space address of MCU control
-        },
+        &atxmega128b3_xmega_desc,
     },
     // DEV_ATXMEGA64B1
     {
@@ -5476,9 +5423,7 @@ jtag_device_def_type deviceDefinitions[] = {
         NULL,   // registers not yet defined
         true,
         0x37, 0x0000, // fuses
-        {
-            0   // no mkI support
-        },
+        NULL,			// no mkI support
         {
             CMND_SET_DEVICE_DESCRIPTOR,
             { 0xFF,0xFF,0xFF,0xF9,0xFF,0x3D,0xB9,0xF8 }, // ucReadIO
@@ -5525,26 +5470,7 @@ jtag_device_def_type deviceDefinitions[] = {
             0,  // ucEindAddress
             fill_b2(0), // EECRAddress
         },
-        {
-            CMND_SET_XMEGA_PARAMS, // cmd
-            fill_b2(2),         // whatever
-            47,                 // length of following data
-            fill_b4(0x800000),  // NVM offset for application flash
-            fill_b4(0x810000),  // NVM offset for boot flash
-            fill_b4(0x8c0000),  // NVM offset for EEPROM
-            fill_b4(0x8f0020),  // NVM offset for fuses
-            fill_b4(0x8f0027),  // NVM offset for lock bits
-            fill_b4(0x8e0400),  // NVM offset for user signature row
-            fill_b4(0x8e0200),  // NVM offset for production sig. row
-            fill_b4(0x1000000), // NVM offset for data memory
-            fill_b4(65536),    // size of application flash
-            fill_b2(4096),      // size of boot flash
-            fill_b2(256),       // flash page size
-            fill_b2(2048),      // size of EEPROM
-            32,                 // EEPROM page size
-            fill_b2(0x1c0),     // IO space base address of NVM controller
-            fill_b2(0x90),      // IO space address of MCU control
-        },
+        &atxmega64b1_xmega_desc,
     },
     // DEV_ATXMEGA64B3
     {
@@ -5557,9 +5483,7 @@ jtag_device_def_type deviceDefinitions[] = {
         NULL,   // registers not yet defined
         true,
         0x37, 0x0000, // fuses
-        {
-            0   // no mkI support
-        },
+        NULL,			// no mkI support
         {
             CMND_SET_DEVICE_DESCRIPTOR,
             { 0xFF,0xFF,0xFF,0xF9,0xFF,0x3D,0xB9,0xF8 }, // ucReadIO
@@ -5606,26 +5530,7 @@ jtag_device_def_type deviceDefinitions[] = {
             0,  // ucEindAddress
             fill_b2(0), // EECRAddress
         },
-        {
-            CMND_SET_XMEGA_PARAMS, // cmd
-            fill_b2(2),         // whatever
-            47,                 // length of following data
-            fill_b4(0x800000),  // NVM offset for application flash
-            fill_b4(0x810000),  // NVM offset for boot flash
-            fill_b4(0x8c0000),  // NVM offset for EEPROM
-            fill_b4(0x8f0020),  // NVM offset for fuses
-            fill_b4(0x8f0027),  // NVM offset for lock bits
-            fill_b4(0x8e0400),  // NVM offset for user signature row
-            fill_b4(0x8e0200),  // NVM offset for production sig. row
-            fill_b4(0x1000000), // NVM offset for data memory
-            fill_b4(65536),    // size of application flash
-            fill_b2(4096),      // size of boot flash
-            fill_b2(256),       // flash page size
-            fill_b2(2048),      // size of EEPROM
-            32,                 // EEPROM page size
-            fill_b2(0x1c0),     // IO space base address of NVM controller
-            fill_b2(0x90),      // IO space address of MCU control
-        },
+        &atxmega64b3_xmega_desc,
     },
     // Termination record.
     { 
@@ -5638,10 +5543,95 @@ jtag_device_def_type deviceDefinitions[] = {
 	NULL,			// io reg defs
 	false,			// is_xmega
 	0x00, 0x0000,		// fuses
-	{ 0 },			// mkI device descriptor information
+	NULL,			// mkI device descriptor information
 	{ 0 },			// mkII device descriptor
-	{ 0 },			// Xmega device descr.
+	NULL,			// Xmega device descr.
     }
 };
 
 
+
+/*
+ * Device lookup.  The hash tables use open addressing with linear
+ * probing, and are at most half full.  Devices are entered in table
+ * order, so where several share a name or ID, the first one is found,
+ * as with a linear search.
+ */
+
+static jtag_device_def_type **nameHash, **idHash;
+static unsigned int hashMask;
+
+static unsigned int hashName(const char *name)
+{
+    // FNV-1a, on the lower case name
+    unsigned int h = 2166136261U;
+
+    for (; *name != '\0'; name++)
+    {
+	h ^= (unsigned char)tolower((unsigned char)*name);
+	h *= 16777619U;
+    }
+    return h;
+}
+
+static unsigned int hashId(unsigned int id)
+{
+    unsigned int h = id * 2654435761U;
+
+    return h ^ (h >> 16);
+}
+
+static void buildDeviceHashes(void)
+{
+    unsigned int n = 0, size = 16;
+    jtag_device_def_type *dev;
+
+    for (dev = deviceDefinitions; dev->name != NULL; dev++)
+	n++;
+    while (size < 2 * n)
+	size *= 2;
+
+    hashMask = size - 1;
+    nameHash = new jtag_device_def_type *[size];
+    idHash = new jtag_device_def_type *[size];
+    memset(nameHash, 0, size * sizeof *nameHash);
+    memset(idHash, 0, size * sizeof *idHash);
+
+    for (dev = deviceDefinitions; dev->name != NULL; dev++)
+    {
+	unsigned int i;
+
+	for (i = hashName(dev->name); nameHash[i & hashMask] != NULL; i++)
+	    ;
+	nameHash[i & hashMask] = dev;
+	for (i = hashId(dev->device_id); idHash[i & hashMask] != NULL; i++)
+	    ;
+	idHash[i & hashMask] = dev;
+    }
+}
+
+jtag_device_def_type *findDeviceByName(const char *name)
+{
+    jtag_device_def_type *dev;
+
+    if (nameHash == NULL)
+	buildDeviceHashes();
+    for (unsigned int i = hashName(name);
+	 (dev = nameHash[i & hashMask]) != NULL; i++)
+	if (strcasecmp(dev->name, name) == 0)
+	    return dev;
+    return NULL;
+}
+
+jtag_device_def_type *findDeviceById(unsigned int id)
+{
+    jtag_device_def_type *dev;
+
+    if (idHash == NULL)
+	buildDeviceHashes();
+    for (unsigned int i = hashId(id);
+	 (dev = idHash[i & hashMask]) != NULL; i++)
+	if (dev->device_id == id)
+	    return dev;
+    return NULL;
+}
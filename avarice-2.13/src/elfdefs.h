@@ -0,0 +1,116 @@
+/*
+ *	avarice - The "avarice" program.
+ *
+ *	This program is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License Version 2
+ *	as published by the Free Software Foundation.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111, USA.
+ *
+ * Just the bits of <elf.h> we need.  AVR ELF files are always 32-bit
+ * little-endian, so we encode and decode them by hand rather than
+ * relying on the host's <elf.h>.
+ */
+
+#ifndef INCLUDE_ELFDEFS_H
+#define INCLUDE_ELFDEFS_H
+
+enum
+{
+    EI_NIDENT		= 16,
+    ELFCLASS32		= 1,
+    ELFDATA2LSB		= 1,
+    EV_CURRENT		= 1,
+    ET_CORE		= 4,
+    EM_AVR		= 83,
+
+    // ELF header field offsets
+    EH_TYPE		= 16,
+    EH_MACHINE		= 18,
+    EH_VERSION		= 20,
+    EH_ENTRY		= 24,
+    EH_PHOFF		= 28,
+    EH_SHOFF		= 32,
+    EH_FLAGS		= 36,
+    EH_EHSIZE		= 40,
+    EH_PHENTSIZE	= 42,
+    EH_PHNUM		= 44,
+    EH_SHENTSIZE	= 46,
+    EH_SHNUM		= 48,
+    EH_SHSTRNDX		= 50,
+    EH_SIZE		= 52,
+
+    // program header field offsets
+    PH_TYPE		= 0,
+    PH_OFFSET		= 4,
+    PH_VADDR		= 8,
+    PH_PADDR		= 12,
+    PH_FILESZ		= 16,
+    PH_MEMSZ		= 20,
+    PH_FLAGS		= 24,
+    PH_ALIGN		= 28,
+    PH_SIZEOF		= 32,
+
+    PT_LOAD		= 1,
+    PT_NOTE		= 4,
+    PF_X		= 1,
+    PF_W		= 2,
+    PF_R		= 4,
+
+    // section header field offsets
+    SH_TYPE		= 4,
+    SH_OFFSET		= 16,
+    SH_SIZE		= 20,
+    SH_LINK		= 24,
+    SH_SIZEOF		= 40,
+
+    SHT_SYMTAB		= 2,
+
+    // symbol table entry field offsets
+    ST_NAME		= 0,
+    ST_VALUE		= 4,
+    ST_SIZE		= 8,
+    ST_INFO		= 12,
+    ST_SHNDX		= 14,
+    ST_SIZEOF		= 16,
+
+    STT_NOTYPE		= 0,
+    STT_OBJECT		= 1,
+    STT_FUNC		= 2,
+    SHN_UNDEF		= 0,
+    SHN_LORESERVE	= 0xff00,
+};
+
+static inline unsigned int elfU16(const unsigned char *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+static inline unsigned long elfU32(const unsigned char *p)
+{
+    return (unsigned long)p[0] | ((unsigned long)p[1] << 8) |
+	((unsigned long)p[2] << 16) | ((unsigned long)p[3] << 24);
+}
+
+static inline void elfPutU16(unsigned char *p, unsigned int v)
+{
+    p[0] = v & 0xff;
+    p[1] = (v >> 8) & 0xff;
+}
+
+static inline void elfPutU32(unsigned char *p, unsigned long v)
+{
+    p[0] = v & 0xff;
+    p[1] = (v >> 8) & 0xff;
+    p[2] = (v >> 16) & 0xff;
+    p[3] = (v >> 24) & 0xff;
+}
+
+#endif /* INCLUDE_ELFDEFS_H */
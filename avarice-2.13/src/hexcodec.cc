@@ -0,0 +1,311 @@
+/*
+ *	avarice - The "avarice" program.
+ *
+ *	This program is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License Version 2
+ *	as published by the Free Software Foundation.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111, USA.
+ *
+ * This file implements hex encoding and decoding of GDB remote
+ * protocol payloads.
+ *
+ * Besides a table driven scalar version, there are SSE2 and AVX2
+ * versions for x86 hosts, selected at run time depending on the CPU.
+ * They are compiled with the respective target attribute, so no
+ * special compiler options are needed.
+ */
+
+#include <string.h>
+
+#include "hexcodec.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#  define HEXCODEC_X86 1
+#  include <immintrin.h>
+#else
+#  define HEXCODEC_X86 0
+#endif
+
+static const char hexDigits[] = "0123456789abcdef";
+
+// Value of each character as a hex digit, 0xff if it is none.
+static unsigned char hexValues[256];
+static char hexPairs[256][2];
+static bool tablesReady;
+
+static void initTables(void)
+{
+    memset(hexValues, 0xff, sizeof hexValues);
+    for (int i = 0; i < 16; i++)
+    {
+	hexValues[(unsigned char)hexDigits[i]] = i;
+	if (i >= 10)
+	    hexValues['A' + i - 10] = i;
+    }
+    for (int i = 0; i < 256; i++)
+    {
+	hexPairs[i][0] = hexDigits[i >> 4];
+	hexPairs[i][1] = hexDigits[i & 0xf];
+    }
+    tablesReady = true;
+}
+
+static bool scalarAvailable(void)
+{
+    return true;
+}
+
+static void scalarEncode(const unsigned char *src, unsigned int len,
+			 char *dst)
+{
+    if (!tablesReady)
+	initTables();
+
+    for (unsigned int i = 0; i < len; i++)
+    {
+	dst[2 * i] = hexPairs[src[i]][0];
+	dst[2 * i + 1] = hexPairs[src[i]][1];
+    }
+}
+
+static bool scalarDecode(const char *src, unsigned int len,
+			 unsigned char *dst)
+{
+    unsigned char bad = 0;
+
+    if (!tablesReady)
+	initTables();
+
+    for (unsigned int i = 0; i < len; i++)
+    {
+	unsigned char hi = hexValues[(unsigned char)src[2 * i]];
+	unsigned char lo = hexValues[(unsigned char)src[2 * i + 1]];
+
+	bad |= hi | lo;
+	dst[i] = (hi << 4) | (lo & 0xf);
+    }
+
+    // Valid digits are at most 0x0f.
+    return (bad & 0xf0) == 0;
+}
+
+#if HEXCODEC_X86
+
+static bool sse2Available(void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+}
+
+static bool avx2Available(void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+/*
+ * Encoding: split each byte into two nibbles, interleave them (high
+ * nibble first), and map 0..15 to '0'..'9', 'a'..'f' by adding '0',
+ * and 'a' - '0' - 10 more where the nibble exceeds 9.
+ *
+ * Decoding: classify each character as digit (c - '0' in 0..9) or
+ * letter ((c | 0x20) - 'a' in 0..5) using signed compares, so
+ * characters >= 0x80 fall out as negative.  Then combine adjacent
+ * nibbles within each 16-bit lane, and pack the lanes to bytes.
+ */
+
+__attribute__((target("sse2")))
+static inline __m128i sse2NibblesToHex(__m128i n)
+{
+    __m128i gt9 = _mm_cmpgt_epi8(n, _mm_set1_epi8(9));
+
+    n = _mm_add_epi8(n, _mm_set1_epi8('0'));
+    return _mm_add_epi8(n, _mm_and_si128(gt9, _mm_set1_epi8('a' - '0' - 10)));
+}
+
+__attribute__((target("sse2")))
+static void sse2Encode(const unsigned char *src, unsigned int len, char *dst)
+{
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    unsigned int i = 0;
+
+    for (; i + 16 <= len; i += 16)
+    {
+	__m128i in = _mm_loadu_si128((const __m128i *)(src + i));
+	__m128i hi = _mm_and_si128(_mm_srli_epi16(in, 4), mask);
+	__m128i lo = _mm_and_si128(in, mask);
+
+	_mm_storeu_si128((__m128i *)(dst + 2 * i),
+			 sse2NibblesToHex(_mm_unpacklo_epi8(hi, lo)));
+	_mm_storeu_si128((__m128i *)(dst + 2 * i + 16),
+			 sse2NibblesToHex(_mm_unpackhi_epi8(hi, lo)));
+    }
+    scalarEncode(src + i, len - i, dst + 2 * i);
+}
+
+/** Decode 16 hex digits into 8 bytes in the low byte of each 16-bit
+    lane; 'bad' collects a non-zero mask if there was an invalid one.
+**/
+__attribute__((target("sse2")))
+static inline __m128i sse2HexToLanes(__m128i c, __m128i &bad)
+{
+    __m128i d = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+    __m128i l = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)),
+			     _mm_set1_epi8('a'));
+    __m128i isd = _mm_and_si128(_mm_cmpgt_epi8(d, _mm_set1_epi8(-1)),
+				_mm_cmplt_epi8(d, _mm_set1_epi8(10)));
+    __m128i isl = _mm_and_si128(_mm_cmpgt_epi8(l, _mm_set1_epi8(-1)),
+				_mm_cmplt_epi8(l, _mm_set1_epi8(6)));
+    __m128i v = _mm_or_si128(_mm_and_si128(isd, d),
+			     _mm_and_si128(isl, _mm_add_epi8(l, _mm_set1_epi8(10))));
+
+    bad = _mm_or_si128(bad, _mm_andnot_si128(_mm_or_si128(isd, isl),
+					     _mm_set1_epi8(-1)));
+    // lane = first digit | second digit << 8 -> first << 4 | second
+    return _mm_or_si128(_mm_and_si128(_mm_slli_epi16(v, 4), _mm_set1_epi16(0xf0)),
+			_mm_srli_epi16(v, 8));
+}
+
+__attribute__((target("sse2")))
+static bool sse2Decode(const char *src, unsigned int len, unsigned char *dst)
+{
+    __m128i bad = _mm_setzero_si128();
+    unsigned int i = 0;
+
+    for (; i + 16 <= len; i += 16)
+    {
+	__m128i a = _mm_loadu_si128((const __m128i *)(src + 2 * i));
+	__m128i b = _mm_loadu_si128((const __m128i *)(src + 2 * i + 16));
+
+	a = sse2HexToLanes(a, bad);
+	b = sse2HexToLanes(b, bad);
+	_mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(a, b));
+    }
+    if (_mm_movemask_epi8(bad) != 0)
+	return false;
+
+    return scalarDecode(src + 2 * i, len - i, dst + i);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i avx2NibblesToHex(__m256i n)
+{
+    __m256i gt9 = _mm256_cmpgt_epi8(n, _mm256_set1_epi8(9));
+
+    n = _mm256_add_epi8(n, _mm256_set1_epi8('0'));
+    return _mm256_add_epi8(n, _mm256_and_si256(gt9,
+					       _mm256_set1_epi8('a' - '0' - 10)));
+}
+
+__attribute__((target("avx2")))
+static void avx2Encode(const unsigned char *src, unsigned int len, char *dst)
+{
+    const __m256i mask = _mm256_set1_epi8(0x0f);
+    unsigned int i = 0;
+
+    for (; i + 32 <= len; i += 32)
+    {
+	__m256i in = _mm256_loadu_si256((const __m256i *)(src + i));
+	__m256i hi = _mm256_and_si256(_mm256_srli_epi16(in, 4), mask);
+	__m256i lo = _mm256_and_si256(in, mask);
+	// Unpacking works within 128-bit halves: a holds bytes 0-7 and
+	// 16-23, b holds bytes 8-15 and 24-31.
+	__m256i a = avx2NibblesToHex(_mm256_unpacklo_epi8(hi, lo));
+	__m256i b = avx2NibblesToHex(_mm256_unpackhi_epi8(hi, lo));
+
+	_mm256_storeu_si256((__m256i *)(dst + 2 * i),
+			    _mm256_permute2x128_si256(a, b, 0x20));
+	_mm256_storeu_si256((__m256i *)(dst + 2 * i + 32),
+			    _mm256_permute2x128_si256(a, b, 0x31));
+    }
+    sse2Encode(src + i, len - i, dst + 2 * i);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i avx2HexToLanes(__m256i c, __m256i &bad)
+{
+    __m256i d = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+    __m256i l = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)),
+				_mm256_set1_epi8('a'));
+    __m256i isd = _mm256_and_si256(_mm256_cmpgt_epi8(d, _mm256_set1_epi8(-1)),
+				   _mm256_cmpgt_epi8(_mm256_set1_epi8(10), d));
+    __m256i isl = _mm256_and_si256(_mm256_cmpgt_epi8(l, _mm256_set1_epi8(-1)),
+				   _mm256_cmpgt_epi8(_mm256_set1_epi8(6), l));
+    __m256i v = _mm256_or_si256(_mm256_and_si256(isd, d),
+				_mm256_and_si256(isl,
+						 _mm256_add_epi8(l, _mm256_set1_epi8(10))));
+
+    bad = _mm256_or_si256(bad, _mm256_andnot_si256(_mm256_or_si256(isd, isl),
+						   _mm256_set1_epi8(-1)));
+    return _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi16(v, 4),
+					    _mm256_set1_epi16(0xf0)),
+			   _mm256_srli_epi16(v, 8));
+}
+
+__attribute__((target("avx2")))
+static bool avx2Decode(const char *src, unsigned int len, unsigned char *dst)
+{
+    __m256i bad = _mm256_setzero_si256();
+    unsigned int i = 0;
+
+    for (; i + 32 <= len; i += 32)
+    {
+	__m256i a = _mm256_loadu_si256((const __m256i *)(src + 2 * i));
+	__m256i b = _mm256_loadu_si256((const __m256i *)(src + 2 * i + 32));
+
+	a = avx2HexToLanes(a, bad);
+	b = avx2HexToLanes(b, bad);
+	// Packing works within 128-bit halves as well; put the 64-bit
+	// quarters back in order.
+	_mm256_storeu_si256((__m256i *)(dst + i),
+			    _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b),
+						     0xd8));
+    }
+    if (_mm256_movemask_epi8(bad) != 0)
+	return false;
+
+    return sse2Decode(src + 2 * i, len - i, dst + i);
+}
+
+#endif // HEXCODEC_X86
+
+const hex_codec hexCodecs[] =
+{
+    { "scalar",	scalarAvailable,	scalarEncode,	scalarDecode },
+#if HEXCODEC_X86
+    { "sse2",	sse2Available,		sse2Encode,	sse2Decode },
+    { "avx2",	avx2Available,		avx2Encode,	avx2Decode },
+#endif
+    { 0, 0, 0, 0 }
+};
+
+static const hex_codec *bestCodec;
+
+static const hex_codec *selectCodec(void)
+{
+    if (bestCodec == 0)
+    {
+	for (const hex_codec *hc = hexCodecs; hc->name != 0; hc++)
+	    if (hc->available())
+		bestCodec = hc;
+    }
+    return bestCodec;
+}
+
+void hexEncode(const unsigned char *src, unsigned int len, char *dst)
+{
+    selectCodec()->encode(src, len, dst);
+}
+
+bool hexDecode(const char *src, unsigned int len, unsigned char *dst)
+{
+    return selectCodec()->decode(src, len, dst);
+}
@@ -0,0 +1,50 @@
+/*
+ *	avarice - The "avarice" program.
+ *
+ *	This program is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License Version 2
+ *	as published by the Free Software Foundation.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111, USA.
+ *
+ * Interface definition for the hex encoder/decoder used for GDB
+ * remote protocol payloads (hexcodec.cc).
+ */
+
+#ifndef INCLUDE_HEXCODEC_H
+#define INCLUDE_HEXCODEC_H
+
+/** Convert 'len' bytes at 'src' into 2 * 'len' lower-case hex digits
+    at 'dst'.  No terminating NUL is written.
+**/
+void hexEncode(const unsigned char *src, unsigned int len, char *dst);
+
+/** Convert 2 * 'len' hex digits (either case) at 'src' into 'len'
+    bytes at 'dst'.  Returns false if any character is not a hex
+    digit, in which case the contents of 'dst' are undefined.
+**/
+bool hexDecode(const char *src, unsigned int len, unsigned char *dst);
+
+/** One implementation of the above. **/
+struct hex_codec
+{
+    const char *name;
+    bool (*available)(void);	// usable on this CPU?
+    void (*encode)(const unsigned char *src, unsigned int len, char *dst);
+    bool (*decode)(const char *src, unsigned int len, unsigned char *dst);
+};
+
+/** All implementations, the scalar one first, terminated by an entry
+    with a NULL name.  hexEncode()/hexDecode() use the last available
+    one.
+**/
+extern const hex_codec hexCodecs[];
+
+#endif /* INCLUDE_HEXCODEC_H */
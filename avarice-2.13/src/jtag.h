@@ -190,17 +190,27 @@ typedef struct {
                                        // fuse byte, so 0x00008000 for megaAVRs (Xmega
                                        // devices don't have OCDEN at all)
 
-    jtag1_device_desc_type dev_desc1;  // Device descriptor to download to
-                                       // mkI device
+    jtag1_device_desc_type *dev_desc1; // Device descriptor to download to
+                                       // mkI device, NULL if unsupported
     jtag2_device_desc_type dev_desc2;  // Device descriptor to download to
                                        // mkII device
-    xmega_device_desc_type dev_desc3;  // Device descriptor to download for
+    xmega_device_desc_type *dev_desc3; // Device descriptor to download for
                                        // Xmega devices in new (7+) firmware
-                                       // JTAGICE mkII and AVR Dragon
+                                       // JTAGICE mkII and AVR Dragon, NULL
+                                       // for other devices
 } jtag_device_def_type;
 
 extern jtag_device_def_type deviceDefinitions[];
 
+/** Find the device called 'name' (ignoring case), or the first device
+    with JTAG ID or signature 'id'.  Returns NULL if there is none.
+
+    Both use hash tables, built on first use; deviceDefinitions must
+    not be reordered after that.
+**/
+jtag_device_def_type *findDeviceByName(const char *name);
+jtag_device_def_type *findDeviceById(unsigned int id);
+
 // various enums
 enum
 {
@@ -367,6 +377,10 @@ enum
     // entire packet came it.
     MAX_MESSAGE			= 100000,
 
+    // The payload of a received message is read, and its CRC updated,
+    // in pieces of this size.
+    RECV_CHUNK_SIZE		= 4096,
+
     // ICE command codes
     CMND_CHIP_ERASE		= 0x13,
     CMND_CLEAR_EVENTS		= 0x22,
@@ -601,6 +615,12 @@ typedef struct {
     const char *name;
 } BFDimage;
 
+// True if the 'size' bytes at 'addr' in 'image' need not be written,
+// as the input file does not use them (or, for flash, only fills them
+// with the erased value).
+bool pageIsEmpty(BFDimage *image, unsigned int addr, unsigned int size,
+                 BFDmemoryType memtype);
+
 
 // The Sync_CRC/EOP message terminator (no real CRC in sight...)
 #define JTAG_EOM 0x20, 0x20
@@ -638,6 +658,20 @@ class jtag
   // Pointer to device definition
   jtag_device_def_type *deviceDef;
 
+  // Host time (see getTimeUsec()) at which the most recent
+  // breakpoint event arrived from the ICE
+  unsigned long long breakTimestamp;
+
+  // If not 0, jtagContinue() gives up waiting for a breakpoint after
+  // this many us
+  unsigned long long continueTimeout;
+
+  // If not 0, jtagContinue() calls pollHook every pollInterval us
+  // while the target runs.  pollHook returns true if it left the
+  // target stopped at a breakpoint.
+  unsigned long long pollInterval;
+  bool (*pollHook)(void);
+
   // Daisy chain info
   struct {
     unsigned char units_before;
@@ -774,8 +808,10 @@ class jtag
   virtual void jtagSingleStep(void) = 0;
 
   /** Send the program on it's merry way, and wait for a breakpoint or
-      input from gdb.
-      Return true for a breakpoint, false for gdb input. **/
+      input from gdb, or until continueTimeout has passed.  Calls
+      pollHook as set up by pollInterval meanwhile.
+      Return true for a breakpoint, false for gdb input or a timeout;
+      the program is still running in the latter case. **/
   virtual bool jtagContinue(void) = 0;
 
   // R/W memory
@@ -867,6 +903,20 @@ class jtag
   **/
   virtual unsigned int cpuRegisterAreaAddress(void) const = 0;
 
+  /** Return the largest number of bytes a single jtagRead() can
+      fetch in one transfer to the ICE.
+  **/
+  virtual unsigned int maxReadSize(void) const = 0;
+
+  /** Read the ICE's own counts of malformed packets and CRC errors
+      seen since it was powered up.  Returns false if the ICE does not
+      keep them.  The target must be stopped.
+  **/
+  virtual bool getErrorCounters(unsigned long &,
+				unsigned long &) {
+      return false;
+  }
+
 };
 
 class jtag_exception: public exception
@@ -894,6 +944,18 @@ class jtag_timeout_exception: public jtag_exception
     jtag_timeout_exception(): jtag_exception("JTAG ICE timeout exception") {}
 };
 
+/** gdb closed its connection.  'running' is set if the target was
+    running at the time.
+**/
+class gdb_disconnect_exception: public jtag_exception
+{
+  public:
+    bool running;
+
+    gdb_disconnect_exception(bool r = false):
+	jtag_exception("gdb exited"), running(r) {}
+};
+
 extern struct jtag *theJtagICE;
 
 #endif
@@ -83,10 +83,15 @@ class jtag1: public jtag
     breakpoint bpCode[MAX_BREAKPOINTS_CODE], bpData[MAX_BREAKPOINTS_DATA];
     int numBreakpointsCode, numBreakpointsData;
 
+    // Set when the serial line may hold stale input, which the next
+    // command flushes.  In sync, commands go out back to back.
+    bool needFlush;
+
   public:
     jtag1(const char *dev, char *name, bool nsrst = false):
       jtag(dev, name) {
 	apply_nSRST = nsrst;
+	needFlush = true;
     };
 
     virtual void initJtagBox(void);
@@ -125,6 +130,10 @@ class jtag1: public jtag
         /* no Xmega handling in JTAG ICE mkI */
         return DATA_SPACE_ADDR_OFFSET;
     }
+    virtual unsigned int maxReadSize(void) const {
+        /* split into 256 location commands by jtagRead() */
+        return 16 * 1024;
+    }
 
   private:
     virtual void changeBitRate(int newBitRate);
@@ -135,6 +144,7 @@ class jtag1: public jtag
     virtual void configDaisyChain(void);
 
     uchar *getJtagResponse(int responseSize);
+    bool getJtagResponse(uchar *response, int responseSize);
     SendResult sendJtagCommand(uchar *command, int commandSize, int *tries);
     bool checkForEmulator(void);
 
@@ -146,6 +156,10 @@ class jtag1: public jtag
     **/
     uchar *doJtagCommand(uchar *command, int  commandSize, int responseSize);
 
+    /** As above, but reading the response into 'response' **/
+    void doJtagCommand(uchar *command, int commandSize,
+		       uchar *response, int responseSize);
+
     /** Simplified form of doJtagCommand:
 	Send 1-byte command 'cmd' to JTAG ICE, with retries, expecting a
 	'responseSize' byte reponse.
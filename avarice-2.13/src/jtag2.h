@@ -212,8 +212,15 @@ class jtag2: public jtag
     virtual unsigned int cpuRegisterAreaAddress(void) const {
         return is_xmega? REGISTER_SPACE_ADDR_OFFSET: DATA_SPACE_ADDR_OFFSET;
     }
+    virtual unsigned int maxReadSize(void) const {
+        /* the largest flash page; jtagRead() splits paged reads anyway */
+        return MAX_FLASH_PAGE_SIZE;
+    }
 
-  private:
+    virtual bool getErrorCounters(unsigned long &parsingErrors,
+				  unsigned long &crcErrors);
+
+  protected:
     virtual void changeBitRate(int newBitRate);
     virtual void setDeviceDescriptor(jtag_device_def_type *dev);
     virtual bool synchroniseAt(int bitrate);
@@ -290,6 +297,7 @@ class jtag2: public jtag
         [] resp
     **/
     void getJtagParameter(uchar item, uchar *&resp, int &respSize);
+    unsigned long getJtagCounter(uchar item);
 
     uchar memorySpace(unsigned long &addr);
 
@@ -40,6 +40,7 @@
 #include "jtag.h"
 #include "jtag2.h"
 #include "jtag2_defs.h"
+#include "trace.h"
 
 jtag_io_exception::jtag_io_exception(unsigned int code)
 {
@@ -130,6 +131,8 @@ void jtag2::sendFrame(uchar *command, int commandSize)
     else if (count != commandSize + 10)
         // this shouldn't happen
         throw jtag_exception("Invalid write size");
+
+    traceFrame(TRACE_FRAME_TX, command[0], command_sequence, commandSize);
 }
 
 /*
@@ -153,6 +156,7 @@ int jtag2::recvFrame(unsigned char *&msg, unsigned short &seqno)
     unsigned char c, *buf = NULL, header[8];
     unsigned short r_seqno = 0;
     unsigned short checksum = 0;
+    unsigned short crc = CRC_INIT;
 
     msg = NULL;
 
@@ -171,19 +175,41 @@ int jtag2::recvFrame(unsigned char *&msg, unsigned short &seqno)
 		/* skip packet's contents */
 		for(l = 0; l < msglen; l++) {
 		    rv += timeout_read(&c, 1, JTAG_RESPONSE_TIMEOUT);
+#if ENABLE_BYTE_DEBUG
 		    debugOut("ign: 0x%02x\n", c);
+#endif
 		}
 	    } else {
-		rv += timeout_read(buf + 8, msglen, JTAG_RESPONSE_TIMEOUT);
+		/*
+		 * Read the payload in chunks, and update the CRC while
+		 * each chunk is still in the cache, rather than making
+		 * a second pass over the whole frame at the end.
+		 */
+		unsigned int chunk;
+		for (l = 0; l < msglen; l += chunk) {
+		    chunk = msglen - l;
+		    if (chunk > RECV_CHUNK_SIZE)
+			chunk = RECV_CHUNK_SIZE;
+		    if (timeout_read(buf + 8 + l, chunk,
+				     JTAG_RESPONSE_TIMEOUT) != (int)chunk)
+			break;
+		    crc = crcsum(buf + 8 + l, chunk, crc);
+		}
+		if (l == msglen)
+		    rv = 1;
+#if ENABLE_BYTE_DEBUG
 		debugOut("read: ");
 		for (l = 0; l < msglen; l++) {
 		    debugOut(" %02x", buf[l + 8]);
 		}
 		debugOut("\n");
+#endif
 	    }
-	    if (rv == 0)
+	    if (rv == 0) {
 		/* timeout */
+		debugOut("recv: timeout\n");
 		break;
+	    }
 	} else {
 	    rv = timeout_read(&c, 1, JTAG_RESPONSE_TIMEOUT);
 	    if (rv == 0) {
@@ -191,7 +217,9 @@ int jtag2::recvFrame(unsigned char *&msg, unsigned short &seqno)
 		debugOut("recv: timeout\n");
 		break;
 	    }
+#if ENABLE_BYTE_DEBUG
 	    debugOut("recv: 0x%02x\n", c);
+#endif
 	}
 	checksum ^= c;
 
@@ -240,6 +268,7 @@ int jtag2::recvFrame(unsigned char *&msg, unsigned short &seqno)
 		} else {
 		    buf = new unsigned char[msglen + 10];
 		    memcpy(buf, header, 8);
+		    crc = crcsum(header, 8, CRC_INIT);
 		}
 	    } else {
 		state = sSTART;
@@ -257,11 +286,14 @@ int jtag2::recvFrame(unsigned char *&msg, unsigned short &seqno)
 	    break;
 	case sCSUM2:
 	    buf[l++] = c;
-	    if (crcverify(buf, msglen + 10)) {
+	    if (crccheck(buf + msglen + 8, crc)) {
 		debugOut("CRC OK");
+		traceFrame(TRACE_FRAME_RX, msglen > 0? buf[8]: 0, r_seqno,
+			   msglen);
 		state = sDONE;
 	    } else {
 		debugOut("checksum error");
+		traceFrame(TRACE_CRC_ERROR, 0, r_seqno, msglen);
 		delete [] buf;
 		return -1;
 	    }
@@ -273,6 +305,13 @@ int jtag2::recvFrame(unsigned char *&msg, unsigned short &seqno)
 	}
     }
 
+    if (state != sDONE) {
+	/* timeout; don't pass on a partial frame */
+	traceFrame(TRACE_TIMEOUT, 0, r_seqno, msglen);
+	delete [] buf;
+	return 0;
+    }
+
     seqno = r_seqno;
     msg = buf;
 
@@ -307,6 +346,7 @@ int jtag2::recv(uchar *&msg)
 	if (r_seqno == 0xffff) {
 	    debugOut("\ngot asynchronous event: 0x%02x\n",
 		     msg[8]);
+	    traceFrame(TRACE_EVENT, msg[8], r_seqno, rv);
 	    // XXX should we queue that event up somewhere?
 	    // How to process it?  Register event handlers
 	    // for interesting events?
@@ -341,25 +381,33 @@ bool jtag2::sendJtagCommand(uchar *command, int commandSize, int &tries,
 
     debugOut("\ncommand[0x%02x, %d]: ", command[0], tries);
 
+#if ENABLE_BYTE_DEBUG
     for (int i = 0; i < commandSize; i++)
 	debugOut("%.2X ", command[i]);
 
     debugOut("\n");
+#endif
+
+    unsigned long long t0 = traceActive? getTimeUsec(): 0;
 
     sendFrame(command, commandSize);
 
     msgsize = recv(msg);
+    traceCommand(command[0], msgsize > 0? msg[0]: 0, tries,
+		 traceActive? getTimeUsec() - t0: 0);
     if (verify && msgsize == 0)
         throw jtag_exception("no response received");
     else if (msgsize < 1)
 	return false;
 
+#if ENABLE_BYTE_DEBUG
     debugOut("response: ");
     for (int i = 0; i < msgsize; i++)
     {
 	debugOut("%.2X ", msg[i]);
     }
     debugOut("\n");
+#endif
 
     unsigned char c = msg[0];
 
@@ -476,7 +524,11 @@ void jtag2::setDeviceDescriptor(jtag_device_def_type *dev)
     int respSize;
 
     if (is_xmega && has_full_xmega_support)
-	command = (uchar *)&dev->dev_desc3;
+    {
+	if (dev->dev_desc3 == NULL)
+	    throw jtag_exception("No Xmega device descriptor for this device");
+	command = (uchar *)dev->dev_desc3;
+    }
     else
 	command = (uchar *)&dev->dev_desc2;
 
@@ -642,7 +694,7 @@ void jtag2::deviceAutoConfig(void)
     unsigned int device_id;
     uchar *resp;
     int respSize;
-    jtag_device_def_type *pDevice = deviceDefinitions;
+    jtag_device_def_type *pDevice;
 
     // Auto config
     debugOut("Automatic device detection: ");
@@ -689,14 +741,8 @@ void jtag2::deviceAutoConfig(void)
 
     if (device_name == 0)
     {
-        while (pDevice->name)
-        {
-            if (pDevice->device_id == device_id)
-                break;
-
-            pDevice++;
-        }
-        if (pDevice->name == 0)
+        pDevice = findDeviceById(device_id);
+        if (pDevice == NULL)
         {
             fprintf(stderr, "No configuration available for device ID: %0x\n",
                     device_id);
@@ -707,14 +753,8 @@ void jtag2::deviceAutoConfig(void)
     {
         debugOut("Looking for device: %s\n", device_name);
 
-        while (pDevice->name)
-        {
-            if (strcasecmp(pDevice->name, device_name) == 0)
-                break;
-
-            pDevice++;
-        }
-        if (pDevice->name == 0)
+        pDevice = findDeviceByName(device_name);
+        if (pDevice == NULL)
         {
             fprintf(stderr, "No configuration available for device ID: %0x\n",
                     device_id);
@@ -755,17 +795,9 @@ void jtag2::initJtagBox(void)
 
     if (device_name != 0)
     {
-        jtag_device_def_type *pDevice = deviceDefinitions;
-
-        while (pDevice->name)
-        {
-            if (strcasecmp(pDevice->name, device_name) == 0)
-                break;
-
-            pDevice++;
-        }
+        jtag_device_def_type *pDevice = findDeviceByName(device_name);
 
-        if (pDevice->name != 0)
+        if (pDevice != NULL)
         {
             // If a device name has been specified on the command-line,
             // this overrides the is_xmega setting.
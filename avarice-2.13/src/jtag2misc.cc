@@ -94,4 +94,28 @@ void jtag2::getJtagParameter(uchar item, uchar *&resp, int &respSize)
         throw jtag_exception("unexpected response to get paramater command");
 }
 
+/** Read 32-bit counter parameter 'item'. **/
+unsigned long jtag2::getJtagCounter(uchar item)
+{
+    uchar *resp;
+    int respSize;
+    unsigned long value = 0;
+
+    getJtagParameter(item, resp, respSize);
+    for (int i = respSize - 1; i >= 1; i--)
+	value = (value << 8) | resp[i];
+    delete [] resp;
+
+    return value;
+}
+
+bool jtag2::getErrorCounters(unsigned long &parsingErrors,
+			     unsigned long &crcErrors)
+{
+    parsingErrors = getJtagCounter(PAR_PACKET_PARSING_ERRORS);
+    crcErrors = getJtagCounter(PAR_CRC_ERRORS);
+
+    return true;
+}
+
 
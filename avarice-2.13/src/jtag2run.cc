@@ -38,6 +38,7 @@
 #include "jtag.h"
 #include "jtag2.h"
 #include "remote.h"
+#include "metrics.h"
 
 unsigned long jtag2::getProgramCounter(void)
 {
@@ -149,6 +150,8 @@ void jtag2::expectEvent(bool &breakpoint, bool &gdbInterrupt)
     unsigned short seqno;
 
     evtSize = recvFrame(evtbuf, seqno);
+    // Timestamp the event as early as possible.
+    unsigned long long now = getTimeUsec();
     if (evtSize >= 0) {
 	// XXX if not event, should push frame back into queue...
 	// We really need a queue of received frames.
@@ -162,6 +165,7 @@ void jtag2::expectEvent(bool &breakpoint, bool &gdbInterrupt)
 		case EVT_BREAK:
 		    cached_pc = 2 * b4_to_u32(evtbuf + 9);
 		    cached_pc_is_valid = true;
+		    breakTimestamp = now;
 		    /* FALLTHROUGH */
 		case EVT_EXT_RESET:
 		case EVT_PDSB_BREAK:
@@ -240,6 +244,10 @@ bool jtag2::eventLoop(void)
     int maxfd;
     fd_set readfds;
     bool breakpoint = false, gdbInterrupt = false;
+    unsigned long long deadline = continueTimeout == 0? 0:
+	getTimeUsec() + continueTimeout;
+    unsigned long long nextPoll = pollInterval == 0? 0:
+	getTimeUsec() + pollInterval;
 
     // Now that we are "going", wait for either a response from the JTAG
     // box or a nudge from GDB.
@@ -265,14 +273,62 @@ bool jtag2::eventLoop(void)
 	    maxfd = jtagBox > gdbFileDescriptor ? jtagBox : gdbFileDescriptor;
 	  else
 	    maxfd = jtagBox;
+	  metricsAddFds(&readfds, maxfd);
 
-	  int numfds = select(maxfd + 1, &readfds, 0, 0, 0);
+	  struct timeval tv, *timeout = 0;
+	  if (deadline != 0 || nextPoll != 0)
+	    {
+		unsigned long long now = getTimeUsec();
+
+		if (deadline != 0 && now >= deadline)
+		  {
+		      debugOut("continue timed out\n");
+		      return false;
+		  }
+		if (nextPoll != 0 && now >= nextPoll)
+		  {
+		      if (pollHook())
+			  return true;
+		      now = getTimeUsec();
+		      nextPoll = now + pollInterval;
+
+		      // The USB daemon stopped polling when pollHook's
+		      // responses came in.
+		      if (ctrlPipe != -1)
+			{
+			    char cmd[1] = { 'p' };
+			    (void)(write(ctrlPipe, cmd, 1) != 0);
+			}
+		  }
+
+		unsigned long long wake = nextPoll;
+		if (wake == 0 || (deadline != 0 && deadline < wake))
+		    wake = deadline;
+		wake = wake > now? wake - now: 0;
+		tv.tv_sec = wake / 1000000;
+		tv.tv_usec = wake % 1000000;
+		timeout = &tv;
+	    }
+
+	  timeout = metricsTimeout(timeout, &tv);
+	  int numfds = select(maxfd + 1, &readfds, 0, 0, timeout);
 	  if (numfds < 0)
               throw jtag_exception("GDB/JTAG ICE communications failure");
 
+	  metricsHandle(&readfds, false);
+
 	  if (gdbFileDescriptor != -1 && FD_ISSET(gdbFileDescriptor, &readfds))
 	    {
-		int c = getDebugChar();
+		int c;
+
+		try
+		{
+		    c = getDebugChar();
+		}
+		catch (gdb_disconnect_exception&)
+		{
+		    throw gdb_disconnect_exception(true);
+		}
 		if (c == 3) // interrupt
 		  {
 		      debugOut("interrupted by GDB\n");
@@ -37,6 +37,7 @@
 #include "jtag.h"
 #include "jtag2.h"
 #include "remote.h"
+#include "metrics.h"
 
 
 /** Return the memory space code for the memory space indicated by the
@@ -99,6 +100,7 @@ uchar *jtag2::jtagRead(unsigned long addr, unsigned int numBytes)
 	return response;
     }
 
+    metricsMemory(addr, numBytes, false);
     debugOut("jtagRead ");
     uchar whichSpace = memorySpace(addr);
     bool needProgmode = whichSpace >= MTYPE_FLASH_PAGE &&
@@ -158,6 +160,8 @@ uchar *jtag2::jtagRead(unsigned long addr, unsigned int numBytes)
 	{
 	    uchar *resp;
 
+	    metricsCache(whichSpace == MTYPE_FLASH_PAGE,
+			 pageAddr == *cacheBaseAddr);
 	    if (pageAddr == *cacheBaseAddr)
 	    {
 		// quickly fetch from page cache
@@ -224,6 +228,7 @@ void jtag2::jtagWrite(unsigned long addr, unsigned int numBytes, uchar buffer[])
     if (numBytes == 0)
 	return;
 
+    metricsMemory(addr, numBytes, true);
     debugOut("jtagWrite ");
     uchar whichSpace = memorySpace(addr);
 
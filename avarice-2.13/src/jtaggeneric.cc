@@ -64,6 +64,8 @@ jtag::jtag(void)
   jtagBox = 0;
   oldtioValid = is_usb = false;
   ctrlPipe = -1;
+  breakTimestamp = continueTimeout = pollInterval = 0;
+  pollHook = NULL;
 }
 
 jtag::jtag(const char *jtagDeviceName, char *name, emulator type)
@@ -73,6 +75,8 @@ jtag::jtag(const char *jtagDeviceName, char *name, emulator type)
     jtagBox = 0;
     oldtioValid = is_usb = false;
     ctrlPipe = -1;
+    breakTimestamp = continueTimeout = pollInterval = 0;
+    pollHook = NULL;
     device_name = name;
     emu_type = type;
     if (strncmp(jtagDeviceName, "usb", 3) == 0)
@@ -250,8 +254,8 @@ void jtag::changeLocalBitRate(int newBitRate)
         throw jtag_exception();
 }
 
-static bool pageIsEmpty(BFDimage *image, unsigned int addr, unsigned int size,
-                        BFDmemoryType memtype)
+bool pageIsEmpty(BFDimage *image, unsigned int addr, unsigned int size,
+                 BFDmemoryType memtype)
 {
     bool emptyPage = true;
 
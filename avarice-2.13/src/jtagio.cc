@@ -37,6 +37,7 @@
 #include "avarice.h"
 #include "jtag.h"
 #include "jtag1.h"
+#include "trace.h"
 
 /** Send a command to the jtag, and check result.
 
@@ -54,14 +55,23 @@ SendResult jtag1::sendJtagCommand(uchar *command, int commandSize, int *tries)
 
     debugOut("\ncommand[%c, %d]: ", command[0], *tries);
 
+#if ENABLE_BYTE_DEBUG
     for (int i = 0; i < commandSize; i++)
 	debugOut("%.2X ", command[i]);
 
     debugOut("\n");
+#endif
 
-    // before writing, clean up any "unfinished business".
-    if (tcflush(jtagBox, TCIFLUSH) < 0)
-        throw jtag_exception();
+    // before writing, clean up any "unfinished business" left by a
+    // timeout or garbled response.  While in sync there is none, and
+    // neither flushing nor draining the line would gain anything but
+    // latency.
+    if (needFlush)
+    {
+	if (tcflush(jtagBox, TCIFLUSH) < 0)
+	    throw jtag_exception();
+	needFlush = false;
+    }
 
     int count = safewrite(command, commandSize);
     if (count < 0)
@@ -70,9 +80,7 @@ SendResult jtag1::sendJtagCommand(uchar *command, int commandSize, int *tries)
         // this shouldn't happen
         throw jtag_exception();
 
-    // And wait for all characters to go to the JTAG box.... can't hurt!
-    if (tcdrain(jtagBox) < 0)
-        throw jtag_exception();
+    traceFrame(TRACE_FRAME_TX, command[0], 0, commandSize);
 
     // We should get JTAG_R_OK, but we might get JTAG_R_INFO too (we just
     // ignore it)
@@ -87,6 +95,8 @@ SendResult jtag1::sendJtagCommand(uchar *command, int commandSize, int *tries)
 	if (count == 0)
 	{
 	    debugOut("Timed out.\n");
+	    needFlush = true;
+	    traceFrame(TRACE_TIMEOUT, command[0], 0, 0);
 	    return send_failed;
 	}
 
@@ -99,55 +109,81 @@ SendResult jtag1::sendJtagCommand(uchar *command, int commandSize, int *tries)
 	    /* An info ("IDR dirty") response. Ignore it. */
 	    debugOut("Info response: ");
 	    count = timeout_read(infobuf, 2, JTAG_RESPONSE_TIMEOUT);
+#if ENABLE_BYTE_DEBUG
 	    for (int i = 0; i < count; i++)
 	    {
 		debugOut("%.2X ", infobuf[i]);
 	    }
 	    debugOut("\n");
+#endif
 	    if (count != 2 || infobuf[1] != JTAG_R_OK)
+	    {
+		needFlush = true;
 		return send_failed;
+	    }
 	    else
 		return (SendResult)(mcu_data + infobuf[0]);
 	    break;
 	default:
 	    debugOut("Out of sync, reponse was `%02x'\n", ok);
+	    needFlush = true;
 	    return send_failed;
 	}
       }
 }
 
-/** Get a 'responseSize' byte response from the JTAG ICE
+/** Read a 'responseSize' byte response from the JTAG ICE into
+    'response'.
 
-    Returns NULL if no bytes received for JTAG_COMM_TIMEOUT microseconds
-    Returns a dynamically allocated buffer containing the reponse (caller
-    must free) otherwise
+    Returns false if no bytes received for JTAG_COMM_TIMEOUT microseconds
 **/
-uchar *jtag1::getJtagResponse(int responseSize)
+bool jtag1::getJtagResponse(uchar *response, int responseSize)
 {
-    uchar *response;
     int numCharsRead;
 
-    // Increase by 1 because of the zero termination.
-    //
-    // note: IT IS THE CALLERS RESPONSIBILITY TO delete() THIS.
-    response = new uchar[responseSize + 1];
-    response[responseSize] = '\0';
-
     numCharsRead = timeout_read(response, responseSize,
                                 JTAG_RESPONSE_TIMEOUT);
     if (numCharsRead < 0)
         throw jtag_exception();
 
+#if ENABLE_BYTE_DEBUG
     debugOut("response: ");
     for (int i = 0; i < numCharsRead; i++)
     {
 	debugOut("%.2X ", response[i]);
     }
     debugOut("\n");
+#endif
 
     if (numCharsRead < responseSize) // timeout problem
     {
 	debugOut("Timed Out (partial response)\n");
+	traceFrame(TRACE_TIMEOUT, 0, 0, numCharsRead);
+	needFlush = true;
+	return false;
+    }
+
+    return true;
+}
+
+/** Get a 'responseSize' byte response from the JTAG ICE
+
+    Returns NULL if no bytes received for JTAG_COMM_TIMEOUT microseconds
+    Returns a dynamically allocated buffer containing the reponse (caller
+    must free) otherwise
+**/
+uchar *jtag1::getJtagResponse(int responseSize)
+{
+    uchar *response;
+
+    // Increase by 1 because of the zero termination.
+    //
+    // note: IT IS THE CALLERS RESPONSIBILITY TO delete() THIS.
+    response = new uchar[responseSize + 1];
+    response[responseSize] = '\0';
+
+    if (!getJtagResponse(response, responseSize))
+    {
 	delete [] response;
 	return NULL;
     }
@@ -155,25 +191,32 @@ uchar *jtag1::getJtagResponse(int responseSize)
     return response;
 }
 
-uchar *jtag1::doJtagCommand(uchar *command, int  commandSize, int  responseSize)
+void jtag1::doJtagCommand(uchar *command, int commandSize,
+			  uchar *response, int responseSize)
 {
     int tryCount = 0;
 
     // Send command until we get RESP_OK
     for (;;)
     {
-	uchar *response;
+	bool ok;
+	uchar signon[8];
 	static uchar sync[] = { ' ' };
 	static uchar stop[] = { 'S', JTAG_EOM };
+	unsigned long long t0 = traceActive? getTimeUsec(): 0;
 
 	switch (sendJtagCommand(command, commandSize, &tryCount))
 	{
 	case send_ok:
-	    response = getJtagResponse(responseSize);
-	    if (response == NULL)
+	    ok = getJtagResponse(response, responseSize);
+	    traceCommand(command[0], ok? JTAG_R_OK: 0, tryCount,
+			 traceActive? getTimeUsec() - t0: 0);
+	    if (!ok)
                 throw jtag_exception();
-	    return response;
+	    return;
 	case send_failed:
+	    traceCommand(command[0], 0, tryCount,
+			 traceActive? getTimeUsec() - t0: 0);
 	    // We're out of sync. Attempt to resync.
 	    while (sendJtagCommand(sync, sizeof sync, &tryCount) != send_ok) 
 		;
@@ -187,11 +230,31 @@ uchar *jtag1::doJtagCommand(uchar *command, int  commandSize, int  responseSize)
 	       bit more intrusive --- it should be ok, as we currently only
 	       send commands to stopped targets, but...) */
 	    if (sendJtagCommand(stop, sizeof stop, &tryCount) == send_ok)
-		getJtagResponse(8);
+		getJtagResponse(signon, sizeof signon);
 	    break;
 	}
     }
+}
+
+uchar *jtag1::doJtagCommand(uchar *command, int  commandSize, int  responseSize)
+{
+    // Increase by 1 because of the zero termination.
+    //
+    // note: IT IS THE CALLERS RESPONSIBILITY TO delete() THIS.
+    uchar *response = new uchar[responseSize + 1];
+    response[responseSize] = '\0';
+
+    try
+    {
+	doJtagCommand(command, commandSize, response, responseSize);
+    }
+    catch (jtag_exception&)
+    {
+	delete [] response;
+	throw;
+    }
 
+    return response;
 }
 
 bool jtag1::doSimpleJtagCommand(unsigned char cmd, int responseSize)
@@ -241,9 +304,11 @@ void jtag1::changeBitRate(int newBitRate)
 void jtag1::setDeviceDescriptor(jtag_device_def_type *dev)
 {
     uchar *response = NULL;
-    uchar *command = (uchar *)(&dev->dev_desc1);
+    uchar *command = (uchar *)dev->dev_desc1;
 
-    response = doJtagCommand(command, sizeof dev->dev_desc1, 1);
+    if (command == NULL)
+        throw jtag_exception("Device is not supported by JTAG ICE mkI");
+    response = doJtagCommand(command, sizeof *dev->dev_desc1, 1);
     if (response[0] != JTAG_R_OK)
         throw jtag_exception ("JTAG ICE: Failed to set device description");
 
@@ -317,7 +382,7 @@ void jtag1::startJtagLink(void)
 void jtag1::deviceAutoConfig(void)
 {
     unsigned int device_id;
-    jtag_device_def_type *pDevice = deviceDefinitions;
+    jtag_device_def_type *pDevice;
 
     // Auto config
     debugOut("Automatic device detection: ");
@@ -345,19 +410,8 @@ void jtag1::deviceAutoConfig(void)
     
     if (device_name == 0)
     {
-        while (pDevice->name)
-        {
-            if (pDevice->device_id == device_id)
-                break;
-
-            pDevice++;
-        }
-	if ((pDevice->device_flags & DEVFL_MKII_ONLY) != 0)
-        {
-            fprintf(stderr, "Device is not supported by JTAG ICE mkI");
-            throw jtag_exception();
-        }
-        if (pDevice->name == 0)
+        pDevice = findDeviceById(device_id);
+        if (pDevice == NULL)
         {
             fprintf(stderr, "No configuration available for device ID: %0x\n",
                     device_id);
@@ -368,25 +422,19 @@ void jtag1::deviceAutoConfig(void)
     {
         debugOut("Looking for device: %s\n", device_name);
 
-        while (pDevice->name)
-        {
-            if (strcasecmp(pDevice->name, device_name) == 0)
-                break;
-
-            pDevice++;
-        }
-	if ((pDevice->device_flags & DEVFL_MKII_ONLY) != 0)
-        {
-            fprintf(stderr, "Device is not supported by JTAG ICE mkI");
-            throw jtag_exception();
-        }
-        if (pDevice->name == 0)
+        pDevice = findDeviceByName(device_name);
+        if (pDevice == NULL)
         {
             fprintf(stderr, "No configuration available for Device: %s\n",
                     device_name);
             throw jtag_exception();
         }
     }
+    if ((pDevice->device_flags & DEVFL_MKII_ONLY) != 0)
+    {
+        fprintf(stderr, "Device is not supported by JTAG ICE mkI");
+        throw jtag_exception();
+    }
 
     if (device_name)
     {
@@ -37,6 +37,7 @@
 #include "jtag.h"
 #include "jtag1.h"
 #include "remote.h"
+#include "metrics.h"
 
 unsigned long jtag1::getProgramCounter(void)
 {
@@ -122,6 +123,11 @@ bool jtag1::jtagContinue(void)
 	return true;
     }
 
+    unsigned long long deadline = continueTimeout == 0? 0:
+	getTimeUsec() + continueTimeout;
+    unsigned long long nextPoll = pollInterval == 0? 0:
+	getTimeUsec() + pollInterval;
+
     for (;;)
     {
 	int maxfd;
@@ -135,20 +141,61 @@ bool jtag1::jtagContinue(void)
 	// Check for input from JTAG ICE (breakpoint, sleep, info, power)
 	// or gdb (user break)
 	FD_ZERO (&readfds);
-	FD_SET (gdbFileDescriptor, &readfds);
+	if (gdbFileDescriptor != -1)
+	    FD_SET (gdbFileDescriptor, &readfds);
 	FD_SET (jtagBox, &readfds);
 	maxfd = jtagBox > gdbFileDescriptor ? jtagBox : gdbFileDescriptor;
+	metricsAddFds(&readfds, maxfd);
+
+	struct timeval tv, *timeout = 0;
+	if (deadline != 0 || nextPoll != 0)
+	{
+	    unsigned long long now = getTimeUsec();
+
+	    if (deadline != 0 && now >= deadline)
+	    {
+		debugOut("continue timed out\n");
+		return false;
+	    }
+	    if (nextPoll != 0 && now >= nextPoll)
+	    {
+		if (pollHook())
+		    return true;
+		now = getTimeUsec();
+		nextPoll = now + pollInterval;
+	    }
 
-	int numfds = select(maxfd + 1, &readfds, 0, 0, 0);
+	    unsigned long long wake = nextPoll;
+	    if (wake == 0 || (deadline != 0 && deadline < wake))
+		wake = deadline;
+	    wake = wake > now? wake - now: 0;
+	    tv.tv_sec = wake / 1000000;
+	    tv.tv_usec = wake % 1000000;
+	    timeout = &tv;
+	}
+
+	timeout = metricsTimeout(timeout, &tv);
+	int numfds = select(maxfd + 1, &readfds, 0, 0, timeout);
 	if (numfds < 0)
         {
             fprintf(stderr, "GDB/JTAG ICE communications failure");
             throw jtag_exception();
         }
 
-	if (FD_ISSET(gdbFileDescriptor, &readfds))
+	metricsHandle(&readfds, false);
+
+	if (gdbFileDescriptor != -1 && FD_ISSET(gdbFileDescriptor, &readfds))
 	{
-	    int c = getDebugChar();
+	    int c;
+
+	    try
+	    {
+		c = getDebugChar();
+	    }
+	    catch (gdb_disconnect_exception&)
+	    {
+		throw gdb_disconnect_exception(true);
+	    }
 	    if (c == 3) // interrupt
 	    {
 		debugOut("interrupted by GDB\n");
@@ -186,6 +233,7 @@ bool jtag1::jtagContinue(void)
 	    switch (response)
 	    {
 	    case JTAG_R_BREAK:
+		breakTimestamp = getTimeUsec();
 		count = timeout_read(buf, 2, JTAG_RESPONSE_TIMEOUT);
 		if (count < 2)
 		    throw jtag_exception();
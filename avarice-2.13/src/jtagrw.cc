@@ -37,6 +37,7 @@
 #include "jtag.h"
 #include "jtag1.h"
 #include "remote.h"
+#include "metrics.h"
 
 
 /** Return the memory space code for the memory space indicated by the
@@ -84,6 +85,7 @@ uchar *jtag1::jtagRead(unsigned long addr, unsigned int numBytes)
 {
     uchar *response;
     int whichSpace = 0;
+    unsigned int numLocations, locationSize, offset;
     uchar command[] = { 'R', 0, 0, 0, 0, 0, JTAG_EOM }; 
 
     if (numBytes == 0)
@@ -93,86 +95,99 @@ uchar *jtag1::jtagRead(unsigned long addr, unsigned int numBytes)
 	return response;
     }
 
+    metricsMemory(addr, numBytes, false);
+
     debugOut("jtagRead ");
     whichSpace = memorySpace(&addr);
     if (whichSpace)
     {
-	command[1] = whichSpace;
-	if (numBytes > 256)
-	    return NULL;
-	command[2] = numBytes - 1;
-	encodeAddress(&command[3], addr);
-
-	// Response will be the number of data bytes with an 'A' at the
-	// start and end. As such, the response size will be number of bytes
-	// + 2. Then add an additional byte for the trailing zero (see
-	// protocol document).
-
-	response = doJtagCommand(command, sizeof command, numBytes + 2);
-
-	if (response[numBytes + 1] == JTAG_R_OK)
-	    return response;
-
-	delete [] response;
-
-	return NULL;
+	numLocations = numBytes;
+	locationSize = 1;
+	offset = 0;
     }
     else
     {
-
 	// Reading program memory
 	whichSpace = programmingEnabled ?
 	    ADDR_PROG_SPACE_PROG_ENABLED : ADDR_PROG_SPACE_PROG_DISABLED;
 
 	// Program space is 16 bits wide, with word reads
-	int numLocations;
-	if (addr & 1)
-	    numLocations = (numBytes + 2) / 2;
-	else
-	    numLocations = (numBytes + 1) / 2;
-	if (numLocations > 256)
-	    return NULL;
+	offset = addr & 1;
+	numLocations = (numBytes + offset + 1) / 2;
+	locationSize = 2;
+	addr /= 2;
+    }
 
-	command[1] = whichSpace;
-	command[2] = numLocations - 1;
-	encodeAddress(&command[3], addr / 2);
+    // Each command reads at most 256 locations. The response will be the
+    // data with an 'A' at the start and end, and a zero before the final
+    // 'A' (see protocol document). The leading 'A' is consumed by
+    // sendJtagCommand(); the data goes straight to its place in the
+    // result, and the two trailing bytes are overwritten by the data of
+    // the next command.
+    response = new uchar[numLocations * locationSize + 2 + 1];
+    response[numLocations * locationSize + 2] = '\0';
+
+    uchar *dest = response;
+    while (numLocations > 0)
+    {
+	unsigned int n = numLocations > 256? 256: numLocations;
+	unsigned int len = n * locationSize;
 
-	response = doJtagCommand(command, sizeof command, numLocations * 2 + 2);
+	command[1] = whichSpace;
+	command[2] = n - 1;
+	encodeAddress(&command[3], addr);
 
-	if (response[numLocations * 2 + 1] == JTAG_R_OK)
+	try
 	{
-	    // Programming mode and regular mode are byte-swapped...
-	    if (!programmingEnabled)
-		swapBytes(response, numLocations * 2);
+	    doJtagCommand(command, sizeof command, dest, len + 2);
+	}
+	catch (jtag_exception&)
+	{
+	    delete [] response;
+	    throw;
+	}
+	if (dest[len + 1] != JTAG_R_OK)
+	{
+	    delete [] response;
+	    return NULL;
+	}
 
-	    if (addr & 1)
-		// we read one byte early. move stuff down.
-		memmove(response, response + 1, numBytes);
+	// Programming mode and regular mode are byte-swapped...
+	if (locationSize == 2 && !programmingEnabled)
+	    swapBytes(dest, len);
 
-	    return response;
-	}
+	dest += len;
+	addr += n;
+	numLocations -= n;
     }
 
-    delete [] response;
-    
-    return NULL;
+    if (offset)
+	// we read one byte early. move stuff down.
+	memmove(response, response + 1, numBytes);
+
+    return response;
 }
 
 void jtag1::jtagWrite(unsigned long addr, unsigned int numBytes, uchar buffer[])
 {
-    uchar *response;
+    uchar response[1];
     int whichSpace = 0;
-    unsigned int numLocations;
+    unsigned int numLocations, locationSize;
     uchar command[] = { 'W', 0, 0, 0, 0, 0, JTAG_EOM }; 
 
     if (numBytes == 0)
 	return;
 
+    metricsMemory(addr, numBytes, true);
+
     debugOut("jtagWrite ");
     whichSpace = memorySpace(&addr);
 
     if (whichSpace)
+    {
 	numLocations = numBytes;
+	locationSize = 1;
+    }
     else
     {
 	// Writing program memory, which is word (16-bit) addressed
@@ -192,6 +207,7 @@ void jtag1::jtagWrite(unsigned long addr, unsigned int numBytes, uchar buffer[])
 
 	addr /= 2;
 	numLocations = numBytes / 2;
+	locationSize = 2;
 
 	if (programmingEnabled)
 	    whichSpace = ADDR_PROG_SPACE_PROG_ENABLED;
@@ -202,25 +218,6 @@ void jtag1::jtagWrite(unsigned long addr, unsigned int numBytes, uchar buffer[])
 	}
     }
 
-    // This is the maximum write size
-    if (numLocations > 256)
-	throw jtag_exception("Attempt to write more than 256 bytes");
-
-    // Writing is a two part process
-
-    // Part 1: send the address
-    command[1] = whichSpace;
-    command[2] = numLocations - 1;
-    encodeAddress(&command[3], addr);
-
-    response = doJtagCommand(command, sizeof command, 0);
-    if (!response)
-	throw jtag_exception();
-    delete [] response;
-
-    // Part 2: send the data in the following form:
-    // h [data byte]...[data byte] __
-
     // Before we begin, a little note on the endianness.
     // Firstly, data space is 8 bits wide and the only data written by
     // this routine will be byte-wide, so endianness does not matter.
@@ -234,19 +231,44 @@ void jtag1::jtagWrite(unsigned long addr, unsigned int numBytes, uchar buffer[])
     // to program space are for code download, it is simpler at this
     // stage to simply pass the data straight through. This may need to
     // change in the future.
-    uchar *txBuffer = new uchar[numBytes + 3]; // allow for header and trailer
+
+    // This is the maximum write size per command
+    uchar *txBuffer = new uchar[256 * locationSize + 3]; // allow for header and trailer
     txBuffer[0] = 'h';
 
-    memcpy(&txBuffer[1], buffer, numBytes);
+    try
+    {
+	while (numLocations > 0)
+	{
+	    unsigned int n = numLocations > 256? 256: numLocations;
+	    unsigned int len = n * locationSize;
 
-    txBuffer[numBytes + 1] = ' ';
-    txBuffer[numBytes + 2] = ' ';
+	    // Writing is a two part process
 
-    response = doJtagCommand(txBuffer, numBytes + 3, 1);
-    delete [] txBuffer;
+	    // Part 1: send the address
+	    command[1] = whichSpace;
+	    command[2] = n - 1;
+	    encodeAddress(&command[3], addr);
 
-    if (!response)
-	throw jtag_exception();
-    delete [] response;
-}
+	    doJtagCommand(command, sizeof command, response, 0);
+
+	    // Part 2: send the data in the following form:
+	    // h [data byte]...[data byte] __
+	    memcpy(&txBuffer[1], buffer, len);
+	    txBuffer[len + 1] = ' ';
+	    txBuffer[len + 2] = ' ';
+
+	    doJtagCommand(txBuffer, len + 3, response, 1);
 
+	    buffer += len;
+	    addr += n;
+	    numLocations -= n;
+	}
+    }
+    catch (jtag_exception&)
+    {
+	delete [] txBuffer;
+	throw;
+    }
+    delete [] txBuffer;
+}
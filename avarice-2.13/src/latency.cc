@@ -0,0 +1,262 @@
+/*
+ *	avarice - The "avarice" program.
+ *
+ *	This program is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License Version 2
+ *	as published by the Free Software Foundation.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111, USA.
+ *
+ * This file implements measuring the time the target takes between
+ * two code locations, using one breakpoint at either location.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "avarice.h"
+#include "jtag.h"
+#include "remote.h"
+#include "symbols.h"
+#include "latency.h"
+
+bool parseCodeAddress(const char *spec, unsigned long &addr)
+{
+    unsigned int size;
+    char *endptr;
+
+    if (isdigit((unsigned char)spec[0]))
+    {
+	addr = strtoul(spec, &endptr, 0);
+	if (*endptr != '\0')
+	{
+	    fprintf(stderr, "Invalid address \"%s\"\n", spec);
+	    return false;
+	}
+    }
+    else if (!lookupSymbol(spec, addr, size))
+    {
+	if (!symbolsLoaded())
+	    fprintf(stderr, "Cannot resolve \"%s\": no ELF file loaded\n",
+		    spec);
+	else
+	    fprintf(stderr, "Symbol \"%s\" not found\n", spec);
+	return false;
+    }
+
+    if (addr >= DATA_SPACE_ADDR_OFFSET)
+    {
+	fprintf(stderr, "%s is not a code address\n", spec);
+	return false;
+    }
+    return true;
+}
+
+static int comparetimes(const void *a, const void *b)
+{
+    unsigned long long ta = *(const unsigned long long *)a;
+    unsigned long long tb = *(const unsigned long long *)b;
+
+    return ta < tb? -1: ta > tb? 1: 0;
+}
+
+static unsigned long readTimer(unsigned long addr, unsigned int size)
+{
+    uchar *mem = theJtagICE->jtagRead(addr, size);
+    unsigned long val = 0;
+
+    if (mem == NULL)
+	throw jtag_exception("cannot read timer register");
+    // AVR 16-bit timers must be read low byte first, which is what
+    // jtagRead() does.
+    for (unsigned int i = size; i-- > 0;)
+	val = (val << 8) | mem[i];
+    delete [] mem;
+
+    return val;
+}
+
+/** Print minimum, average, 99th percentile and maximum of the 'n'
+    values in 'v' (which gets sorted), and a histogram of them.  Values
+    are multiplied by 'scale' for display.
+**/
+static void reportLatencies(void (*report)(const char *fmt, ...),
+			    const char *what, unsigned long long *v,
+			    unsigned long n, double scale, const char *unit)
+{
+    unsigned long long sum = 0;
+
+    qsort(v, n, sizeof(unsigned long long), comparetimes);
+    for (unsigned long i = 0; i < n; i++)
+	sum += v[i];
+
+    unsigned long p99 = (99 * n + 99) / 100;
+    if (p99 > 0)
+	p99--;
+
+    report("%s: min %.1f, avg %.1f, p99 %.1f, max %.1f %s\n",
+	   what, v[0] * scale, (double)sum / n * scale, v[p99] * scale,
+	   v[n - 1] * scale, unit);
+
+    unsigned long long lo = v[0], range = v[n - 1] - v[0] + 1;
+    unsigned long bins[LATENCY_HISTOGRAM_BINS], maxbin = 0;
+    int nbins = range < LATENCY_HISTOGRAM_BINS? (int)range:
+	LATENCY_HISTOGRAM_BINS;
+
+    memset(bins, 0, sizeof bins);
+    for (unsigned long i = 0; i < n; i++)
+    {
+	unsigned long b = (v[i] - lo) * nbins / range;
+	if (++bins[b] > maxbin)
+	    maxbin = bins[b];
+    }
+    for (int b = 0; b < nbins; b++)
+    {
+	char bar[41];
+	int len = bins[b] * 40 / maxbin;
+
+	memset(bar, '#', len);
+	bar[len] = '\0';
+	report("  %10.1f .. %10.1f %s %7lu %s\n",
+	       (lo + b * range / nbins) * scale,
+	       (lo + (b + 1) * range / nbins - 1) * scale, unit,
+	       bins[b], bar);
+    }
+}
+
+void latencyRun(unsigned long start, unsigned long end, unsigned long count,
+		unsigned long timerAddr, unsigned int timerSize,
+		double timerHz, bool toGdb)
+{
+    void (*report)(const char *fmt, ...) = toGdb? gdbOut: statusOut;
+
+    if (count == 0)
+	count = DEFAULT_LATENCY_COUNT;
+    if (timerSize > 4)
+    {
+	report("Timer registers can be at most 4 bytes wide.\n");
+	return;
+    }
+
+    unsigned long timerMask = timerSize == 4? 0xffffffffUL:
+	(1UL << (8 * timerSize)) - 1;
+    unsigned long long *hostTimes = new unsigned long long[count];
+    unsigned long long *timerTicks = new unsigned long long[count];
+    unsigned long long hostStart = 0;
+    unsigned long timerStart = 0;
+    unsigned long n = 0;
+    bool haveStart = false, startSet = false, endSet = false;
+    bool disconnected = false;
+
+    try
+    {
+	if (!(startSet = theJtagICE->addBreakpoint(start, CODE, 0)) ||
+	    (end != start && !(endSet = theJtagICE->addBreakpoint(end, CODE, 0))))
+	    throw jtag_exception("no breakpoint available");
+
+	while (n < count)
+	{
+	    // Step off the breakpoint we are sitting at, as GDB would.
+	    unsigned long pc = theJtagICE->getProgramCounter();
+	    if (pc == start || pc == end)
+		theJtagICE->jtagSingleStep();
+
+	    if (!theJtagICE->jtagContinue())
+	    {
+		report("Interrupted.\n");
+		theJtagICE->interruptProgram();
+		break;
+	    }
+	    unsigned long long stamp = theJtagICE->breakTimestamp;
+
+	    pc = theJtagICE->getProgramCounter();
+	    if (pc != start && pc != end)
+	    {
+		report("Stopped at unrelated address 0x%lx, giving up.\n", pc);
+		break;
+	    }
+
+	    unsigned long ticks = 0;
+	    if (timerSize != 0)
+		ticks = readTimer(timerAddr, timerSize);
+
+	    if (pc == end && haveStart)
+	    {
+		hostTimes[n] = stamp - hostStart;
+		timerTicks[n] = (ticks - timerStart) & timerMask;
+		n++;
+		haveStart = false;
+	    }
+	    if (pc == start)
+	    {
+		hostStart = stamp;
+		timerStart = ticks;
+		haveStart = true;
+	    }
+	}
+    }
+    catch (gdb_disconnect_exception& e)
+    {
+	// Stop the target for the cleanup below, then let the server
+	// loop take over.
+	disconnected = true;
+	if (e.running)
+	{
+	    try
+	    {
+		theJtagICE->interruptProgram();
+	    }
+	    catch (jtag_exception&)
+	    {
+		// nothing more we can do
+	    }
+	}
+    }
+    catch (jtag_exception& e)
+    {
+	report("Latency measurement aborted: %s\n", e.what());
+    }
+
+    try
+    {
+	if (startSet)
+	    theJtagICE->deleteBreakpoint(start, CODE, 0);
+	if (endSet)
+	    theJtagICE->deleteBreakpoint(end, CODE, 0);
+	theJtagICE->updateBreakpoints();
+    }
+    catch (jtag_exception&)
+    {
+	// nothing more we can do
+    }
+
+    if (disconnected)
+    {
+	delete [] hostTimes;
+	delete [] timerTicks;
+	throw gdb_disconnect_exception();
+    }
+    if (n > 0)
+    {
+	report("%lu passes from 0x%lx to 0x%lx\n", n, start, end);
+	reportLatencies(report, "Host time", hostTimes, n, 1.0, "us");
+	if (timerSize != 0 && timerHz > 0)
+	    reportLatencies(report, "Target timer", timerTicks, n,
+			    1e6 / timerHz, "us");
+	else if (timerSize != 0)
+	    reportLatencies(report, "Target timer", timerTicks, n,
+			    1.0, "ticks");
+    }
+
+    delete [] hostTimes;
+    delete [] timerTicks;
+}
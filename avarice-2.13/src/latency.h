@@ -0,0 +1,58 @@
+/*
+ *	avarice - The "avarice" program.
+ *
+ *	This program is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License Version 2
+ *	as published by the Free Software Foundation.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111, USA.
+ *
+ * Interface definition for the breakpoint-to-breakpoint latency
+ * measurement (latency.cc).
+ */
+
+#ifndef INCLUDE_LATENCY_H
+#define INCLUDE_LATENCY_H
+
+enum
+{
+    DEFAULT_LATENCY_COUNT	= 100,
+    LATENCY_HISTOGRAM_BINS	= 16,
+};
+
+/** Parse a code location: a symbol name, or a numeric (C notation)
+    byte address in flash.  Returns false (after printing a diagnostic
+    to stderr) if it could not be resolved.
+**/
+bool parseCodeAddress(const char *spec, unsigned long &addr);
+
+/** Measure the time it takes the target to get from code address
+    'start' to 'end', 'count' times.  If 'start' and 'end' are equal,
+    the time between consecutive passes is measured instead.
+
+    A breakpoint is placed at either address, and the target is
+    resumed automatically after each stop.  The host time at which
+    the ICE reported the breakpoint is used for timing; if 'timerSize'
+    is non-zero, the free-running target timer register at data space
+    address 'timerAddr' (including DATA_SPACE_ADDR_OFFSET) is read at
+    each stop as well.  Its difference does not suffer from host or
+    USB latency jitter, as the JTAG ICE mkII is told to stop the
+    target timers while the target is halted.  Timer ticks are
+    converted to microseconds if 'timerHz' is positive.
+
+    The target must be stopped on entry, and is left stopped on
+    return.  A latency histogram, and minimum, average and 99th
+    percentile are reported to stdout, or the GDB console if 'toGdb'.
+**/
+void latencyRun(unsigned long start, unsigned long end, unsigned long count,
+		unsigned long timerAddr, unsigned int timerSize,
+		double timerHz, bool toGdb);
+
+#endif /* INCLUDE_LATENCY_H */
@@ -44,6 +44,15 @@
 #include "jtag.h"
 #include "jtag1.h"
 #include "jtag2.h"
+#include "symbols.h"
+#include "sampler.h"
+#include "latency.h"
+#include "coredump.h"
+#include "trace.h"
+#include "metrics.h"
+#include "daemon.h"
+#include "batch.h"
+#include "console.h"
 #include "gnu_getopt.h"
 
 bool ignoreInterrupts;
@@ -160,19 +169,41 @@ static void usage(const char *progname)
             "                                values are 1000/500/250/125 kHz (mkI),\n"
 	    "                                or 22 through 6400 kHz (mkII).\n"
             "                                (default: 250 kHz)\n");
+    fprintf(stderr,
+	    "      --batch <file>          Run the steps in script <file> (- for stdin)\n"
+	    "                                and report the results as JSON lines.\n");
+    fprintf(stderr,
+	    "      --batch-output <file>   Write batch results to <file> (default: stdout).\n");
     fprintf(stderr,
 	    "  -C, --capture               Capture running program.\n"
 	    "                                Note: debugging must have been enabled prior\n"
             "                                to starting the program. (e.g., by running\n"
             "                                avarice earlier)\n");
+    fprintf(stderr,
+	    "      --console[=<file>]      Show the output of the target console (needs\n"
+	    "                                --symbols) in gdb, or write it to <file>.\n");
+    fprintf(stderr,
+	    "      --console-poll <ms>     While the target runs, drain the console every\n"
+	    "                                <ms> milliseconds (briefly stopping it).\n");
     fprintf(stderr,
 	    "  -c, --daisy-chain <ub,ua,bb,ba> Daisy chain settings:\n"
 	    "                                <units before, units after,\n"
 	    "                                bits before, bits after>\n");
     fprintf(stderr,
 	    "  -D, --detach                Detach once synced with JTAG ICE\n");
+    fprintf(stderr,
+	    "      --daemon <file>         Supervise one server per target listed in\n"
+	    "                                <file>, each on its own port.\n");
     fprintf(stderr,
 	    "  -d, --debug                 Enable printing of debug information.\n");
+    fprintf(stderr,
+	    "      --dump-core <file>      Write the target state to ELF core file <file>.\n");
+    fprintf(stderr,
+	    "      --dump-core-flash       Include flash contents differing from the\n"
+	    "                                --symbols file in the core file.\n");
+    fprintf(stderr,
+	    "      --ram-end <addr>        Last SRAM address for --dump-core (default:\n"
+	    "                                __stack from the --symbols file).\n");
     fprintf(stderr,
             "  -e, --erase                 Erase target.\n");
     fprintf(stderr,
@@ -201,8 +232,28 @@ static void usage(const char *progname)
 	    "  -k, --known-devices         Print a list of known devices.\n");
     fprintf(stderr,
             "  -L, --write-lockbits <ll>   Write lock bits.\n");
+    fprintf(stderr,
+	    "      --latency <start>,<end> Measure the time from code address <start>\n"
+	    "                                to <end> (symbols or byte addresses).\n");
+    fprintf(stderr,
+	    "      --latency-count <n>     Number of passes to measure (default: 100).\n");
+    fprintf(stderr,
+	    "      --latency-timer <reg>[:<size>]\n"
+	    "                                Free-running timer register to read at\n"
+	    "                                each stop (e.g. 0x800084:2 for TCNT1).\n");
+    fprintf(stderr,
+	    "      --latency-timer-hz <hz> Timer tick rate, to report timer latency in us.\n");
     fprintf(stderr,
             "  -l, --read-lockbits         Read lock bits.\n");
+    fprintf(stderr,
+	    "      --metrics [<host>:]<port>|<path>\n"
+	    "                                Serve Prometheus metrics over HTTP on TCP\n"
+	    "                                <port> (host default: 127.0.0.1), or on the\n"
+	    "                                Unix domain socket <path>.\n");
+    fprintf(stderr,
+            "      --persist[=run|halt]    Keep the JTAG ICE session when gdb disconnects,\n"
+            "                                and wait for the next connection, leaving\n"
+            "                                the target running (default) or halted.\n");
     fprintf(stderr,
             "  -P, --part <name>           Target device name (e.g."
             " atmega16)\n\n");
@@ -214,8 +265,28 @@ static void usage(const char *progname)
 #endif	// ENABLE_TARGET_PROGRAMMING
     fprintf(stderr,
             "  -r, --read-fuses            Read fuses bytes.\n");
+    fprintf(stderr,
+	    "      --sample <var>[:<size>][,...]\n"
+	    "                                Sample the listed target variables while the\n"
+	    "                                program runs.  Variables are symbols from the\n"
+	    "                                --symbols file, or numeric data space addresses.\n");
+    fprintf(stderr,
+	    "      --sample-rate <hz>      Samples per second (default: 100).\n");
+    fprintf(stderr,
+	    "      --sample-count <n>      Number of samples (default: until interrupted).\n");
+    fprintf(stderr,
+	    "      --sample-output <file>  Write samples to <file> (default: stdout).\n");
+    fprintf(stderr,
+	    "      --sample-format <fmt>   Sample output format, csv (default) or binary.\n");
+    fprintf(stderr,
+	    "      --symbols <elffile>     Read target symbols from <elffile>.\n");
     fprintf(stderr,
             "  -R, --reset-srst            External reset through nSRST signal.\n");
+    fprintf(stderr,
+	    "      --trace <file>          Trace the communication with the JTAG ICE, and\n"
+	    "                                write the trace to <file> on exit.\n");
+    fprintf(stderr,
+	    "      --trace-dump <file>     Print trace file <file> and exit.\n");
     fprintf(stderr,
 	    "  -V, --version               Print version information.\n");
 #if ENABLE_TARGET_PROGRAMMING
@@ -291,6 +362,33 @@ static void knownParts()
     exit(1);
 }
 
+// Long options without a short equivalent.
+enum
+{
+    OPT_SAMPLE = 0x100,
+    OPT_SAMPLE_RATE,
+    OPT_SAMPLE_COUNT,
+    OPT_SAMPLE_OUTPUT,
+    OPT_SAMPLE_FORMAT,
+    OPT_SYMBOLS,
+    OPT_LATENCY,
+    OPT_LATENCY_COUNT,
+    OPT_LATENCY_TIMER,
+    OPT_LATENCY_TIMER_HZ,
+    OPT_DUMP_CORE,
+    OPT_DUMP_CORE_FLASH,
+    OPT_RAM_END,
+    OPT_TRACE,
+    OPT_TRACE_DUMP,
+    OPT_METRICS,
+    OPT_DAEMON,
+    OPT_PERSIST,
+    OPT_BATCH,
+    OPT_BATCH_OUTPUT,
+    OPT_CONSOLE,
+    OPT_CONSOLE_POLL,
+};
+
 static struct option long_opts[] = {
     /* name,                 has_arg, flag,   val */
     { "mkI",                 0,       0,     '1' },
@@ -320,6 +418,28 @@ static struct option long_opts[] = {
     { "write-fuses",         1,       0,     'W' },
     { "xmega",               0,       0,     'x' },
     { "pdi",                 0,       0,     'X' },
+    { "sample",              1,       0,     OPT_SAMPLE },
+    { "sample-rate",         1,       0,     OPT_SAMPLE_RATE },
+    { "sample-count",        1,       0,     OPT_SAMPLE_COUNT },
+    { "sample-output",       1,       0,     OPT_SAMPLE_OUTPUT },
+    { "sample-format",       1,       0,     OPT_SAMPLE_FORMAT },
+    { "symbols",             1,       0,     OPT_SYMBOLS },
+    { "latency",             1,       0,     OPT_LATENCY },
+    { "latency-count",       1,       0,     OPT_LATENCY_COUNT },
+    { "latency-timer",       1,       0,     OPT_LATENCY_TIMER },
+    { "latency-timer-hz",    1,       0,     OPT_LATENCY_TIMER_HZ },
+    { "dump-core",           1,       0,     OPT_DUMP_CORE },
+    { "dump-core-flash",     0,       0,     OPT_DUMP_CORE_FLASH },
+    { "ram-end",             1,       0,     OPT_RAM_END },
+    { "trace",               1,       0,     OPT_TRACE },
+    { "trace-dump",          1,       0,     OPT_TRACE_DUMP },
+    { "metrics",             1,       0,     OPT_METRICS },
+    { "daemon",              1,       0,     OPT_DAEMON },
+    { "persist",             2,       0,     OPT_PERSIST },
+    { "batch",               1,       0,     OPT_BATCH },
+    { "batch-output",        1,       0,     OPT_BATCH_OUTPUT },
+    { "console",             2,       0,     OPT_CONSOLE },
+    { "console-poll",        1,       0,     OPT_CONSOLE_POLL },
     { 0,                     0,       0,      0 }
 };
 
@@ -361,6 +481,33 @@ int main(int argc, char **argv)
     unsigned int units_after = 0;
     unsigned int bits_before = 0;
     unsigned int bits_after = 0;
+    const char *symbolFile = NULL;
+    const char *sampleVars = NULL;
+    double sampleRate = DEFAULT_SAMPLE_RATE;
+    unsigned long sampleCount = 0;
+    const char *sampleOutput = NULL;
+    bool sampleBinary = false;
+    char *latencySpec = NULL;
+    unsigned long latencyCount = DEFAULT_LATENCY_COUNT;
+    const char *latencyTimer = NULL;
+    double latencyTimerHz = 0;
+    unsigned long latencyStart = 0, latencyEnd = 0;
+    unsigned long timerAddr = 0;
+    unsigned int timerSize = 0;
+    const char *coreFile = NULL;
+    bool coreFlash = false;
+    unsigned long ramEnd = 0;
+    const char *traceFile = NULL;
+    const char *metricsSpec = NULL;
+    const char *daemonConfig = NULL;
+    const char *batchFile = NULL;
+    const char *batchOutput = NULL;
+    bool console = false;
+    const char *consoleOutput = NULL;
+    double consolePoll = 0;
+    enum {
+	PERSIST_OFF, PERSIST_RUN, PERSIST_HALT
+    } persist = PERSIST_OFF;
 
     statusOut("AVaRICE version %s, %s %s\n\n",
 	      PACKAGE_VERSION, __DATE__, __TIME__);
@@ -475,12 +622,156 @@ int main(int argc, char **argv)
                 is_xmega = true;
                 protocol = MKII_PDI;
                 break;
+	    case OPT_SAMPLE:
+		sampleVars = optarg;
+		break;
+	    case OPT_SAMPLE_RATE:
+		sampleRate = atof(optarg);
+		if (sampleRate <= 0)
+		{
+		    fprintf(stderr, "%s: invalid sample rate %s\n",
+			    progname, optarg);
+		    exit(1);
+		}
+		break;
+	    case OPT_SAMPLE_COUNT:
+		sampleCount = strtoul(optarg, NULL, 0);
+		break;
+	    case OPT_SAMPLE_OUTPUT:
+		sampleOutput = optarg;
+		break;
+	    case OPT_SAMPLE_FORMAT:
+		if (strcmp(optarg, "csv") == 0)
+		    sampleBinary = false;
+		else if (strcmp(optarg, "binary") == 0)
+		    sampleBinary = true;
+		else
+		{
+		    fprintf(stderr, "%s: unknown sample format %s\n",
+			    progname, optarg);
+		    exit(1);
+		}
+		break;
+	    case OPT_SYMBOLS:
+		symbolFile = optarg;
+		break;
+	    case OPT_LATENCY:
+		latencySpec = optarg;
+		break;
+	    case OPT_LATENCY_COUNT:
+		latencyCount = strtoul(optarg, NULL, 0);
+		break;
+	    case OPT_LATENCY_TIMER:
+		latencyTimer = optarg;
+		break;
+	    case OPT_LATENCY_TIMER_HZ:
+		latencyTimerHz = atof(optarg);
+		break;
+	    case OPT_DUMP_CORE:
+		coreFile = optarg;
+		break;
+	    case OPT_DUMP_CORE_FLASH:
+		coreFlash = true;
+		break;
+	    case OPT_RAM_END:
+		ramEnd = strtoul(optarg, NULL, 0);
+		break;
+	    case OPT_TRACE:
+		traceFile = optarg;
+		break;
+	    case OPT_TRACE_DUMP:
+		exit(traceDumpFile(optarg, stdout)? 0: 1);
+	    case OPT_METRICS:
+		metricsSpec = optarg;
+		break;
+	    case OPT_DAEMON:
+		daemonConfig = optarg;
+		break;
+	    case OPT_BATCH:
+		batchFile = optarg;
+		break;
+	    case OPT_BATCH_OUTPUT:
+		batchOutput = optarg;
+		break;
+	    case OPT_CONSOLE:
+		console = true;
+		consoleOutput = optarg;
+		break;
+	    case OPT_CONSOLE_POLL:
+		console = true;
+		consolePoll = atof(optarg);
+		break;
+	    case OPT_PERSIST:
+		if (optarg == NULL || strcmp(optarg, "run") == 0)
+		    persist = PERSIST_RUN;
+		else if (strcmp(optarg, "halt") == 0)
+		    persist = PERSIST_HALT;
+		else
+		{
+		    fprintf(stderr, "%s: --persist takes run or halt\n",
+			    progname);
+		    exit(1);
+		}
+		break;
             default:
                 fprintf (stderr, "getop() did something screwey");
                 exit (1);
         }
     }
 
+    if (daemonConfig != NULL)
+    {
+	// Each server would repeat these whenever it is restarted.
+	if (optind != argc || inFileName != NULL || erase || program ||
+	    verify || readFuses || writeFuses || readLockBits ||
+	    writeLockBits || sampleVars != NULL || latencySpec != NULL ||
+	    coreFile != NULL || metricsSpec != NULL || batchFile != NULL)
+	{
+	    fprintf(stderr, "%s: --daemon only takes options for debugging "
+		    "with gdb\n", progname);
+	    exit(1);
+	}
+	if (!daemonReadConfig(daemonConfig))
+	    exit(1);
+
+	// Only the servers get past here.
+	const daemon_target *t = daemonRun(detach);
+
+	jtagDeviceName = t->jtagDevice;
+	if (t->part != NULL)
+	    device_name = t->part;
+	hostName = t->host;
+	hostPortNumber = t->port;
+	gdbServerMode = true;
+	detach = false;
+	// A restart repeats the whole sign-on, so only a server that
+	// gives up its ICE is restarted.
+	if (persist == PERSIST_OFF)
+	    persist = PERSIST_RUN;
+
+	if (traceFile != NULL)
+	{
+	    static char serverTraceFile[1024];
+
+	    snprintf(serverTraceFile, sizeof serverTraceFile, "%s.%d",
+		     traceFile, hostPortNumber);
+	    traceFile = serverTraceFile;
+	}
+	if (consoleOutput != NULL)
+	{
+	    static char serverConsoleFile[1024];
+
+	    snprintf(serverConsoleFile, sizeof serverConsoleFile, "%s.%d",
+		     consoleOutput, hostPortNumber);
+	    consoleOutput = serverConsoleFile;
+	}
+    }
+
+    if (traceFile != NULL)
+	traceEnable(traceFile);
+    if (metricsSpec != NULL && !metricsListen(metricsSpec))
+	exit(1);
+
     if ((optind+1) == argc) {
         /* Looks like user has given [[host]:port], so parse out the host and
            port number then enable gdb server mode. */
@@ -564,6 +855,30 @@ int main(int argc, char **argv)
     int rv = 0;			// return value from main()
 
     try {
+	// Resolve sampled variables before talking to the ICE, so typos
+	// are caught early.
+	if (symbolFile != NULL)
+	    loadSymbols(symbolFile);
+	if (sampleVars != NULL && !samplerSetVariables(sampleVars))
+	    throw jtag_exception();
+	if (latencySpec != NULL)
+	{
+	    char *comma = strchr(latencySpec, ',');
+	    if (comma == NULL)
+	    {
+		fprintf(stderr, "%s: --latency needs <start>,<end>\n",
+			progname);
+		throw jtag_exception();
+	    }
+	    *comma = '\0';
+	    if (!parseCodeAddress(latencySpec, latencyStart) ||
+		!parseCodeAddress(comma + 1, latencyEnd))
+		throw jtag_exception();
+	}
+	if (latencyTimer != NULL &&
+	    !parseSymbolSpec(latencyTimer, timerAddr, timerSize))
+	    throw jtag_exception();
+
 	// And say hello to the JTAG box
 	switch (protocol) {
 	case MKI:
@@ -595,6 +910,11 @@ int main(int argc, char **argv)
         // Tell which events to ignore.
         theJtagICE->parseEvents(eventlist);
 
+	if (console &&
+	    !consoleEnable(consoleOutput,
+			   (unsigned long long)(consolePoll * 1000)))
+	    throw jtag_exception();
+
 	// Init JTAG box.
 	theJtagICE->initJtagBox();
 
@@ -688,6 +1008,28 @@ int main(int argc, char **argv)
         if (writeLockBits)
             theJtagICE->jtagWriteLockBits(lockBits);
 
+        if (sampleVars != NULL || latencySpec != NULL || coreFile != NULL ||
+            batchFile != NULL)
+        {
+            // These all want a stopped target in debug mode.
+            if (capture)
+                theJtagICE->interruptProgram();
+            else if (!gdbServerMode)
+                theJtagICE->initJtagOnChipDebugging(jtagBitrate);
+            // Take the snapshot first, before anything else runs.
+            if (coreFile != NULL && !dumpCore(coreFile, coreFlash, ramEnd,
+                                              false))
+                rv = 1;
+            if (sampleVars != NULL)
+                samplerRun(sampleRate, sampleCount, sampleOutput,
+                           sampleBinary, false);
+            if (latencySpec != NULL)
+                latencyRun(latencyStart, latencyEnd, latencyCount,
+                           timerAddr, timerSize, latencyTimerHz, false);
+            if (batchFile != NULL && !batchRun(batchFile, batchOutput))
+                rv = 1;
+        }
+
         // Quit & resume mote for operations that don't interact with gdb.
         if (!gdbServerMode)
             theJtagICE->resumeProgram();
@@ -718,21 +1060,55 @@ int main(int argc, char **argv)
                     }
             }
 
-            // Connection request on original socket.
-            socklen_t size = (socklen_t)sizeof(clientname);
-            int gfd = accept(sock, (struct sockaddr *)&clientname, &size);
-            if (gfd < 0)
-                throw jtag_exception();
-            statusOut("Connection opened by host %s, port %hu.\n",
-                      inet_ntoa(clientname.sin_addr), ntohs(clientname.sin_port));
-
-            setGdbFile(gfd);
-
-            // Now do the actual processing of GDB messages
-            // We stay here until exiting because of error of EOF on the
-            // gdb connection
+            unsigned long long disconnected = 0;
             for (;;)
-                talkToGdb();
+            {
+                // Connection request on original socket.
+                socklen_t size = (socklen_t)sizeof(clientname);
+                int gfd = accept(sock, (struct sockaddr *)&clientname, &size);
+                if (gfd < 0)
+                    throw jtag_exception();
+                statusOut("Connection opened by host %s, port %hu.\n",
+                          inet_ntoa(clientname.sin_addr), ntohs(clientname.sin_port));
+                if (disconnected != 0)
+                    statusOut("Reconnected after %.3f s, ICE session kept.\n",
+                              (getTimeUsec() - disconnected) / 1e6);
+
+                setGdbFile(gfd);
+
+                // Now do the actual processing of GDB messages
+                // We stay here until exiting because of error of EOF on the
+                // gdb connection
+                try
+                {
+                    for (;;)
+                        talkToGdb();
+                }
+                catch (gdb_disconnect_exception& e)
+                {
+                    if (persist == PERSIST_OFF)
+                    {
+                        theJtagICE->resumeProgram();
+                        throw;
+                    }
+
+                    // Hand the target over to the next gdb the way it
+                    // found the first one: stopped, without the
+                    // breakpoints of the previous session, and then
+                    // running again unless asked otherwise.
+                    disconnected = getTimeUsec();
+                    close(gfd);
+                    gdbFileDescriptor = -1;
+                    if (e.running)
+                        theJtagICE->interruptProgram();
+                    theJtagICE->deleteAllBreakpoints();
+                    theJtagICE->updateBreakpoints();
+                    if (persist == PERSIST_RUN)
+                        theJtagICE->resumeProgram();
+                    statusOut("Waiting for connection on port %hu.\n",
+                              hostPortNumber);
+                }
+            }
         }
     }
     catch (const char *msg)
@@ -0,0 +1,319 @@
+/*
+ *	avarice - The "avarice" program.
+ *
+ *	This program is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License Version 2
+ *	as published by the Free Software Foundation.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111, USA.
+ *
+ * This file implements tracking which parts of the data space changed
+ * between consecutive stops of the target.
+ *
+ * The previous snapshot is kept on the host, so only the changes need
+ * to be logged or shown.  Data spaces are small, but soak tests stop
+ * the target often, so the comparison skips over equal memory 16 bytes
+ * at a time where SSE2 is available, and a machine word at a time
+ * otherwise.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "avarice.h"
+#include "jtag.h"
+#include "remote.h"
+#include "symbols.h"
+#include "coredump.h"
+#include "memdiff.h"
+
+struct diff_run
+{
+    unsigned long start;
+    unsigned long len;
+};
+
+static uchar *prevImage, *curImage;
+static unsigned long imageSize;
+
+static diff_run *diffRuns;		// changes found by the last update
+static unsigned long numDiffRuns, maxDiffRuns;
+static unsigned long diffSeq;
+
+static FILE *deltaLog;
+
+/** Return the first offset at or after 'from' where 'a' and 'b'
+    differ, or 'size' if there is none.
+**/
+static unsigned long nextDifference(const uchar *a, const uchar *b,
+				    unsigned long from, unsigned long size)
+{
+    unsigned long i = from;
+
+#if defined(__SSE2__)
+    for (; i + 16 <= size; i += 16)
+    {
+	__m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+	__m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+	unsigned int ne = _mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) ^ 0xffff;
+
+	if (ne != 0)
+	    return i + __builtin_ctz(ne);
+    }
+#else
+    for (; i + sizeof(unsigned long) <= size; i += sizeof(unsigned long))
+    {
+	unsigned long wa, wb;
+
+	memcpy(&wa, a + i, sizeof wa);
+	memcpy(&wb, b + i, sizeof wb);
+	if (wa != wb)
+	    break;
+    }
+#endif
+    for (; i < size; i++)
+	if (a[i] != b[i])
+	    return i;
+
+    return size;
+}
+
+static void addRun(unsigned long start, unsigned long end)
+{
+    if (numDiffRuns > 0)
+    {
+	diff_run *last = &diffRuns[numDiffRuns - 1];
+
+	if (start - (last->start + last->len) <= MEMDIFF_MERGE_GAP)
+	{
+	    last->len = end - last->start;
+	    return;
+	}
+    }
+    if (numDiffRuns == maxDiffRuns)
+    {
+	maxDiffRuns = maxDiffRuns? 2 * maxDiffRuns: 64;
+	diff_run *n = new diff_run[maxDiffRuns];
+	memcpy(n, diffRuns, numDiffRuns * sizeof(diff_run));
+	delete [] diffRuns;
+	diffRuns = n;
+    }
+    diffRuns[numDiffRuns].start = start;
+    diffRuns[numDiffRuns].len = end - start;
+    numDiffRuns++;
+}
+
+static void putLEB128(unsigned long v)
+{
+    do
+    {
+	uchar b = v & 0x7f;
+
+	v >>= 7;
+	if (v != 0)
+	    b |= 0x80;
+	putc(b, deltaLog);
+    }
+    while (v != 0);
+}
+
+static void putLE(unsigned long long v, int n)
+{
+    for (int i = 0; i < n; i++)
+	putc((int)((v >> (8 * i)) & 0xff), deltaLog);
+}
+
+static void logDiff(const uchar *image)
+{
+    unsigned long pos = 0;
+
+    putLE(diffSeq, 4);
+    putLE(getTimeUsec(), 8);
+    putLEB128(numDiffRuns);
+    for (unsigned long i = 0; i < numDiffRuns; i++)
+    {
+	putLEB128(diffRuns[i].start - pos);
+	putLEB128(diffRuns[i].len);
+	fwrite(image + diffRuns[i].start, 1, diffRuns[i].len, deltaLog);
+	pos = diffRuns[i].start + diffRuns[i].len;
+    }
+    fflush(deltaLog);
+}
+
+bool memdiffEnable(unsigned long ramEnd, const char *logfile, bool toGdb)
+{
+    void (*report)(const char *fmt, ...) = toGdb? gdbOut: statusOut;
+
+    memdiffDisable();
+
+    imageSize = resolveRamEnd(ramEnd, report) + 1;
+    prevImage = new uchar[imageSize];
+    curImage = new uchar[imageSize];
+
+    try
+    {
+	readDataSpace(prevImage, imageSize);
+    }
+    catch (jtag_exception& e)
+    {
+	report("Cannot take snapshot: %s\n", e.what());
+	memdiffDisable();
+	return false;
+    }
+
+    if (logfile != NULL)
+    {
+	if ((deltaLog = fopen(logfile, "ab")) == NULL)
+	{
+	    report("Cannot open %s\n", logfile);
+	    memdiffDisable();
+	    return false;
+	}
+	if (ftell(deltaLog) == 0)
+	{
+	    fputs("AVDL", deltaLog);
+	    putLE(imageSize, 4);
+	}
+    }
+
+    report("Tracking data space changes up to 0x%lx.\n", imageSize - 1);
+    return true;
+}
+
+void memdiffDisable(void)
+{
+    delete [] prevImage;
+    delete [] curImage;
+    delete [] diffRuns;
+    prevImage = curImage = NULL;
+    diffRuns = NULL;
+    numDiffRuns = maxDiffRuns = 0;
+    diffSeq = 0;
+    if (deltaLog != NULL)
+    {
+	fclose(deltaLog);
+	deltaLog = NULL;
+    }
+}
+
+bool memdiffEnabled(void)
+{
+    return prevImage != NULL;
+}
+
+void memdiffUpdate(void)
+{
+    if (prevImage == NULL)
+	return;
+
+    unsigned long long t0 = getTimeUsec();
+    try
+    {
+	readDataSpace(curImage, imageSize);
+    }
+    catch (jtag_exception& e)
+    {
+	debugOut("memdiff: cannot take snapshot: %s\n", e.what());
+	return;
+    }
+    unsigned long long t1 = getTimeUsec();
+
+    numDiffRuns = 0;
+    unsigned long i = nextDifference(prevImage, curImage, 0, imageSize);
+    while (i < imageSize)
+    {
+	unsigned long end = i + 1;
+
+	while (end < imageSize && prevImage[end] != curImage[end])
+	    end++;
+	addRun(i, end);
+	i = nextDifference(prevImage, curImage, end, imageSize);
+    }
+    diffSeq++;
+
+    if (deltaLog != NULL)
+	logDiff(curImage);
+
+    // Keep the old image around for memdiffReport().
+    uchar *tmp = prevImage;
+    prevImage = curImage;
+    curImage = tmp;
+
+    debugOut("memdiff #%lu: %lu runs, read %llu us, compare %llu us\n",
+	     diffSeq, numDiffRuns, t1 - t0, getTimeUsec() - t1);
+}
+
+void memdiffReport(bool toGdb)
+{
+    void (*report)(const char *fmt, ...) = toGdb? gdbOut: statusOut;
+
+    if (prevImage == NULL)
+    {
+	report("Data space change tracking is not enabled.\n");
+	return;
+    }
+    if (diffSeq == 0)
+    {
+	report("No stop since tracking was enabled.\n");
+	return;
+    }
+
+    unsigned long total = 0;
+    for (unsigned long r = 0; r < numDiffRuns; r++)
+	for (unsigned long a = diffRuns[r].start;
+	     a < diffRuns[r].start + diffRuns[r].len; a++)
+	    if (prevImage[a] != curImage[a])
+		total++;
+    report("Stop #%lu: %lu bytes changed.\n", diffSeq, total);
+
+    // Report consecutive changed bytes of the same symbol as one line.
+    for (unsigned long r = 0; r < numDiffRuns; r++)
+    {
+	unsigned long a = diffRuns[r].start, end = a + diffRuns[r].len;
+
+	while (a < end)
+	{
+	    if (prevImage[a] == curImage[a])
+	    {
+		a++;
+		continue;
+	    }
+
+	    unsigned long offset, next, n = 0, first = a;
+	    const char *name = symbolAt(DATA_SPACE_ADDR_OFFSET + a, offset);
+
+	    if (name != NULL)
+	    {
+		while (a < end &&
+		       symbolAt(DATA_SPACE_ADDR_OFFSET + a, next) == name)
+		{
+		    if (prevImage[a] != curImage[a])
+			n++;
+		    a++;
+		}
+		if (offset != 0)
+		    report("  %s+%lu: %lu bytes\n", name, offset, n);
+		else
+		    report("  %s: %lu bytes\n", name, n);
+	    }
+	    else
+	    {
+		while (a < end && prevImage[a] != curImage[a])
+		    a++, n++;
+		report("  0x%lx: %lu bytes\n",
+		       DATA_SPACE_ADDR_OFFSET + first, n);
+	    }
+	}
+    }
+}
@@ -0,0 +1,68 @@
+/*
+ *	avarice - The "avarice" program.
+ *
+ *	This program is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License Version 2
+ *	as published by the Free Software Foundation.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111, USA.
+ *
+ * Interface definition for the data space snapshot/diff facility
+ * (memdiff.cc).
+ *
+ * The delta log starts with the 4 bytes "AVDL", followed by the size
+ * of the data space as a 4-byte little-endian number, followed by one
+ * record per diff:
+ *
+ *   - diff sequence number, 4 bytes little-endian
+ *   - host time in microseconds, 8 bytes little-endian
+ *   - number of runs, unsigned LEB128
+ *   - per run: number of unchanged bytes since the end of the
+ *     previous run (or the start of the data space), unsigned LEB128;
+ *     number of bytes in the run, unsigned LEB128; the new contents
+ *     of these bytes
+ */
+
+#ifndef INCLUDE_MEMDIFF_H
+#define INCLUDE_MEMDIFF_H
+
+enum
+{
+    // Changed runs separated by at most this many unchanged bytes are
+    // merged, as a new run would take about as much space in the log.
+    MEMDIFF_MERGE_GAP	= 4,
+};
+
+/** Start tracking the data space up to address 'ramEnd' (see
+    resolveRamEnd()), taking an initial snapshot of the stopped target.
+    If 'logfile' is not NULL, deltas are appended to it.
+
+    Returns false if the snapshot or opening the log failed.
+**/
+bool memdiffEnable(unsigned long ramEnd, const char *logfile, bool toGdb);
+
+/** Stop tracking, and close the delta log. **/
+void memdiffDisable(void);
+
+/** true iff tracking is enabled **/
+bool memdiffEnabled(void);
+
+/** Take a new snapshot of the stopped target, and compare it to the
+    previous one.  The changes are logged, and kept for
+    memdiffReport().  Does nothing unless tracking is enabled.
+**/
+void memdiffUpdate(void);
+
+/** Report the changes found by the last memdiffUpdate(), by symbol
+    where known.
+**/
+void memdiffReport(bool toGdb);
+
+#endif /* INCLUDE_MEMDIFF_H */
@@ -0,0 +1,651 @@
+/*
+ *	avarice - The "avarice" program.
+ *
+ *	This program is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License Version 2
+ *	as published by the Free Software Foundation.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111, USA.
+ *
+ * This file implements a metrics endpoint for monitoring long running
+ * avarice instances.  Counters are plain arrays updated in place; the
+ * text is only formatted when a scraper asks for it.
+ *
+ * avarice is single threaded, so scrapes are served from the places
+ * that already wait for input (gdb, or the ICE while the target runs).
+ * Connections wait in those select() calls until their request has
+ * arrived.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+
+#include "avarice.h"
+#include "jtag.h"
+#include "metrics.h"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+bool metricsEnabled;
+
+static int metricsSocket = -1;
+
+// A scraper whose request head has not fully arrived yet.
+static struct metricsClient
+{
+    int fd;				// -1 if unused
+    unsigned long long deadline;
+    size_t length;
+    char request[1024];
+} clients[METRICS_MAX_CLIENTS];
+
+// Upper bounds of the command latency histogram buckets, in us.  The
+// last bucket (+Inf) is implicit.
+static const unsigned int latencyBuckets[] =
+{
+    100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000,
+    250000, 500000, 1000000
+};
+static const unsigned int NUM_BUCKETS =
+    sizeof latencyBuckets / sizeof latencyBuckets[0];
+
+enum
+{
+    SPACE_FLASH,
+    SPACE_DATA,
+    SPACE_EEPROM,
+    SPACE_FUSE,
+    SPACE_LOCK,
+    SPACE_SIG,
+    SPACE_REGISTER,
+    SPACE_BREAKPOINT,
+    NUM_SPACES
+};
+
+static const char *spaceNames[NUM_SPACES] =
+{
+    "flash", "data", "eeprom", "fuse", "lock", "signature", "register",
+    "breakpoint"
+};
+
+static struct
+{
+    unsigned long long commands[256];		// by opcode
+    unsigned long long commandUsec[256];
+    unsigned long long failed[256];		// no response
+    unsigned long long latency[NUM_BUCKETS + 1];
+    unsigned long long latencyCount, latencyUsec;
+    unsigned long long retries, timeouts, crcErrors, events;
+    unsigned long long frames[2], frameBytes[2];	// tx, rx
+    unsigned long long memoryBytes[NUM_SPACES][2];	// read, write
+    unsigned long long cache[2][2];		// [flash][hit]
+    unsigned long long packets[256];		// by first character
+    unsigned long long scrapes;
+} counts;
+
+// The ICE's own error counters, as of iceErrorsTime.
+static bool iceErrorsValid;
+static unsigned long iceParsingErrors, iceCrcErrors;
+static unsigned long long iceErrorsTime;
+
+void metricsRecord(const trace_record &r)
+{
+    switch (r.type)
+    {
+    case TRACE_FRAME_TX:
+    case TRACE_FRAME_RX:
+    {
+	int rx = r.type == TRACE_FRAME_RX;
+
+	counts.frames[rx]++;
+	counts.frameBytes[rx] += r.length;
+	break;
+    }
+    case TRACE_COMMAND:
+    {
+	unsigned int i;
+
+	counts.commands[r.cmd]++;
+	counts.commandUsec[r.cmd] += r.latency;
+	if (r.rsp == 0)
+	    counts.failed[r.cmd]++;
+	if (r.tries > 1)
+	    counts.retries++;
+	for (i = 0; i < NUM_BUCKETS && r.latency > latencyBuckets[i]; i++)
+	    ;
+	counts.latency[i]++;
+	counts.latencyCount++;
+	counts.latencyUsec += r.latency;
+	break;
+    }
+    case TRACE_TIMEOUT:
+	counts.timeouts++;
+	break;
+    case TRACE_CRC_ERROR:
+	counts.crcErrors++;
+	break;
+    case TRACE_EVENT:
+	counts.events++;
+	break;
+    }
+}
+
+void metricsCountMemory(unsigned long addr, unsigned int numBytes, bool write)
+{
+    unsigned int space;
+
+    switch (addr & ADDR_SPACE_MASK)
+    {
+    case DATA_SPACE_ADDR_OFFSET:	space = SPACE_DATA; break;
+    case EEPROM_SPACE_ADDR_OFFSET:	space = SPACE_EEPROM; break;
+    case FUSE_SPACE_ADDR_OFFSET:	space = SPACE_FUSE; break;
+    case LOCK_SPACE_ADDR_OFFSET:	space = SPACE_LOCK; break;
+    case SIG_SPACE_ADDR_OFFSET:		space = SPACE_SIG; break;
+    case REGISTER_SPACE_ADDR_OFFSET:	space = SPACE_REGISTER; break;
+    case BREAKPOINT_SPACE_ADDR_OFFSET:	space = SPACE_BREAKPOINT; break;
+    default:				space = SPACE_FLASH; break;
+    }
+    counts.memoryBytes[space][write] += numBytes;
+}
+
+void metricsCountCache(bool flash, bool hit)
+{
+    counts.cache[flash][hit]++;
+}
+
+void metricsCountPacket(char type)
+{
+    counts.packets[(unsigned char)type]++;
+}
+
+/** A growable output buffer for the scrape response. **/
+struct metricsBuffer
+{
+    char *data;
+    size_t length, size;
+};
+
+static void bufPrintf(metricsBuffer &b, const char *fmt, ...)
+{
+    for (;;)
+    {
+	va_list args;
+	int n;
+
+	va_start(args, fmt);
+	n = vsnprintf(b.data + b.length, b.size - b.length, fmt, args);
+	va_end(args);
+
+	if (n < 0)
+	    return;
+	if ((size_t)n < b.size - b.length)
+	{
+	    b.length += n;
+	    return;
+	}
+
+	size_t size = b.size * 2 + n;
+	char *data = (char *)realloc(b.data, size);
+	if (data == NULL)
+	    return;
+	b.data = data;
+	b.size = size;
+    }
+}
+
+static void pollIceErrors(void)
+{
+    unsigned long long now = getTimeUsec();
+
+    if (iceErrorsValid && now - iceErrorsTime < METRICS_ICE_POLL_USEC)
+	return;
+    iceErrorsTime = now;
+
+    try
+    {
+	iceErrorsValid = theJtagICE->getErrorCounters(iceParsingErrors,
+						      iceCrcErrors);
+    }
+    catch (jtag_exception &e)
+    {
+	debugOut("Reading ICE error counters failed: %s\n", e.what());
+	iceErrorsValid = false;
+    }
+}
+
+static void formatMetrics(metricsBuffer &b)
+{
+    unsigned int i;
+
+    bufPrintf(b,
+	      "# HELP avarice_ice_commands_total ICE command attempts, by opcode.\n"
+	      "# TYPE avarice_ice_commands_total counter\n");
+    for (i = 0; i < 256; i++)
+	if (counts.commands[i] != 0)
+	    bufPrintf(b, "avarice_ice_commands_total{opcode=\"0x%02x\"} %llu\n",
+		      i, counts.commands[i]);
+
+    bufPrintf(b,
+	      "# HELP avarice_ice_command_failures_total ICE commands that got no response.\n"
+	      "# TYPE avarice_ice_command_failures_total counter\n");
+    for (i = 0; i < 256; i++)
+	if (counts.failed[i] != 0)
+	    bufPrintf(b, "avarice_ice_command_failures_total{opcode=\"0x%02x\"} %llu\n",
+		      i, counts.failed[i]);
+
+    bufPrintf(b,
+	      "# HELP avarice_ice_command_seconds_total Time spent in ICE commands, by opcode.\n"
+	      "# TYPE avarice_ice_command_seconds_total counter\n");
+    for (i = 0; i < 256; i++)
+	if (counts.commands[i] != 0)
+	    bufPrintf(b, "avarice_ice_command_seconds_total{opcode=\"0x%02x\"} %.6f\n",
+		      i, counts.commandUsec[i] / 1e6);
+
+    unsigned long long cumulative = 0;
+    bufPrintf(b,
+	      "# HELP avarice_ice_command_latency_seconds ICE command round trip time.\n"
+	      "# TYPE avarice_ice_command_latency_seconds histogram\n");
+    for (i = 0; i < NUM_BUCKETS; i++)
+    {
+	cumulative += counts.latency[i];
+	bufPrintf(b, "avarice_ice_command_latency_seconds_bucket{le=\"%g\"} %llu\n",
+		  latencyBuckets[i] / 1e6, cumulative);
+    }
+    bufPrintf(b,
+	      "avarice_ice_command_latency_seconds_bucket{le=\"+Inf\"} %llu\n"
+	      "avarice_ice_command_latency_seconds_sum %.6f\n"
+	      "avarice_ice_command_latency_seconds_count %llu\n",
+	      counts.latencyCount, counts.latencyUsec / 1e6,
+	      counts.latencyCount);
+
+    bufPrintf(b,
+	      "# HELP avarice_ice_retries_total ICE commands that needed more than one attempt.\n"
+	      "# TYPE avarice_ice_retries_total counter\n"
+	      "avarice_ice_retries_total %llu\n"
+	      "# HELP avarice_ice_timeouts_total ICE responses not received in time.\n"
+	      "# TYPE avarice_ice_timeouts_total counter\n"
+	      "avarice_ice_timeouts_total %llu\n"
+	      "# HELP avarice_ice_crc_errors_total Frames from the ICE dropped because of a bad CRC.\n"
+	      "# TYPE avarice_ice_crc_errors_total counter\n"
+	      "avarice_ice_crc_errors_total %llu\n"
+	      "# HELP avarice_ice_events_total Asynchronous events from the ICE.\n"
+	      "# TYPE avarice_ice_events_total counter\n"
+	      "avarice_ice_events_total %llu\n",
+	      counts.retries, counts.timeouts, counts.crcErrors, counts.events);
+
+    bufPrintf(b,
+	      "# HELP avarice_ice_frames_total Frames exchanged with the ICE.\n"
+	      "# TYPE avarice_ice_frames_total counter\n"
+	      "avarice_ice_frames_total{direction=\"tx\"} %llu\n"
+	      "avarice_ice_frames_total{direction=\"rx\"} %llu\n"
+	      "# HELP avarice_ice_frame_bytes_total Frame payload bytes exchanged with the ICE.\n"
+	      "# TYPE avarice_ice_frame_bytes_total counter\n"
+	      "avarice_ice_frame_bytes_total{direction=\"tx\"} %llu\n"
+	      "avarice_ice_frame_bytes_total{direction=\"rx\"} %llu\n",
+	      counts.frames[0], counts.frames[1],
+	      counts.frameBytes[0], counts.frameBytes[1]);
+
+    bufPrintf(b,
+	      "# HELP avarice_memory_bytes_total Target memory transferred, by address space.\n"
+	      "# TYPE avarice_memory_bytes_total counter\n");
+    for (i = 0; i < NUM_SPACES; i++)
+	bufPrintf(b,
+		  "avarice_memory_bytes_total{space=\"%s\",op=\"read\"} %llu\n"
+		  "avarice_memory_bytes_total{space=\"%s\",op=\"write\"} %llu\n",
+		  spaceNames[i], counts.memoryBytes[i][0],
+		  spaceNames[i], counts.memoryBytes[i][1]);
+
+    bufPrintf(b,
+	      "# HELP avarice_cache_lookups_total Page cache lookups.\n"
+	      "# TYPE avarice_cache_lookups_total counter\n");
+    for (i = 0; i < 2; i++)
+	bufPrintf(b,
+		  "avarice_cache_lookups_total{cache=\"%s\",result=\"hit\"} %llu\n"
+		  "avarice_cache_lookups_total{cache=\"%s\",result=\"miss\"} %llu\n",
+		  i? "flash": "eeprom", counts.cache[i][1],
+		  i? "flash": "eeprom", counts.cache[i][0]);
+
+    bufPrintf(b,
+	      "# HELP avarice_rsp_packets_total gdb packets received, by type.\n"
+	      "# TYPE avarice_rsp_packets_total counter\n");
+    for (i = 0; i < 256; i++)
+    {
+	if (counts.packets[i] == 0)
+	    continue;
+	if (i > ' ' && i < 0x7f && i != '"' && i != '\\')
+	    bufPrintf(b, "avarice_rsp_packets_total{type=\"%c\"} %llu\n",
+		      i, counts.packets[i]);
+	else
+	    bufPrintf(b, "avarice_rsp_packets_total{type=\"0x%02x\"} %llu\n",
+		      i, counts.packets[i]);
+    }
+
+    if (iceErrorsValid)
+	bufPrintf(b,
+		  "# HELP avarice_ice_reported_parsing_errors Packet parsing errors reported by the ICE.\n"
+		  "# TYPE avarice_ice_reported_parsing_errors gauge\n"
+		  "avarice_ice_reported_parsing_errors %lu\n"
+		  "# HELP avarice_ice_reported_crc_errors CRC errors reported by the ICE.\n"
+		  "# TYPE avarice_ice_reported_crc_errors gauge\n"
+		  "avarice_ice_reported_crc_errors %lu\n",
+		  iceParsingErrors, iceCrcErrors);
+
+    bufPrintf(b,
+	      "# HELP avarice_metrics_scrapes_total Metrics requests served.\n"
+	      "# TYPE avarice_metrics_scrapes_total counter\n"
+	      "avarice_metrics_scrapes_total %llu\n",
+	      counts.scrapes);
+}
+
+/** Read what has arrived of the request head of 'c', without
+    waiting.  Returns 1 once it is complete, 0 if more is to come and
+    -1 if the scraper went away.
+**/
+static int readRequest(metricsClient &c)
+{
+    for (;;)
+    {
+	ssize_t n = recv(c.fd, c.request + c.length,
+			 sizeof c.request - 1 - c.length, MSG_DONTWAIT);
+
+	if (n < 0 && errno == EINTR)
+	    continue;
+	if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+	    return 0;
+	if (n <= 0)
+	    return -1;
+	c.length += n;
+	c.request[c.length] = '\0';
+	if (strstr(c.request, "\r\n\r\n") != NULL ||
+	    strstr(c.request, "\n\n") != NULL)
+	    return 1;
+	// Header too long; the request line is all we look at anyway.
+	if (c.length == sizeof c.request - 1)
+	    return 1;
+    }
+}
+
+static void writeAll(int fd, const char *data, size_t length)
+{
+    while (length > 0)
+    {
+	ssize_t n = send(fd, data, length, MSG_NOSIGNAL);
+
+	if (n < 0 && errno == EINTR)
+	    continue;
+	if (n <= 0)
+	    return;
+	data += n;
+	length -= n;
+    }
+}
+
+static void serveScrape(int fd, const char *request, bool iceIdle)
+{
+    metricsBuffer b;
+
+    b.length = 0;
+    b.size = 8192;
+    b.data = (char *)malloc(b.size);
+    if (b.data == NULL)
+	return;
+    b.data[0] = '\0';
+
+    if (strncmp(request, "GET / ", 6) == 0 ||
+	strncmp(request, "GET /metrics ", 13) == 0)
+    {
+	counts.scrapes++;
+	if (iceIdle)
+	    pollIceErrors();
+	formatMetrics(b);
+
+	char head[160];
+	int n = snprintf(head, sizeof head,
+			 "HTTP/1.0 200 OK\r\n"
+			 "Content-Type: text/plain; version=0.0.4\r\n"
+			 "Content-Length: %lu\r\n"
+			 "\r\n", (unsigned long)b.length);
+	writeAll(fd, head, n);
+	writeAll(fd, b.data, b.length);
+    }
+    else
+    {
+	static const char notFound[] =
+	    "HTTP/1.0 404 Not Found\r\n"
+	    "Content-Type: text/plain\r\n"
+	    "\r\n"
+	    "Metrics are at /metrics\n";
+	writeAll(fd, notFound, sizeof notFound - 1);
+    }
+    free(b.data);
+}
+
+static void closeClient(metricsClient &c)
+{
+    close(c.fd);
+    c.fd = -1;
+}
+
+/** Read from client 'c', and serve it once its request is complete. **/
+static void readClient(metricsClient &c, bool iceIdle)
+{
+    int status = readRequest(c);
+
+    if (status > 0)
+	serveScrape(c.fd, c.request, iceIdle);
+    if (status != 0)
+	closeClient(c);
+}
+
+void metricsAddFds(fd_set *readfds, int &maxfd)
+{
+    bool full = true;
+
+    if (metricsSocket < 0)
+	return;
+    for (int i = 0; i < METRICS_MAX_CLIENTS; i++)
+    {
+	int fd = clients[i].fd;
+
+	if (fd < 0)
+	{
+	    full = false;
+	    continue;
+	}
+	FD_SET(fd, readfds);
+	if (fd > maxfd)
+	    maxfd = fd;
+    }
+    // With all slots taken, further scrapers wait in the listen queue.
+    if (!full)
+    {
+	FD_SET(metricsSocket, readfds);
+	if (metricsSocket > maxfd)
+	    maxfd = metricsSocket;
+    }
+}
+
+struct timeval *metricsTimeout(struct timeval *timeout, struct timeval *tv)
+{
+    unsigned long long first = 0;
+
+    for (int i = 0; i < METRICS_MAX_CLIENTS; i++)
+	if (clients[i].fd >= 0 &&
+	    (first == 0 || clients[i].deadline < first))
+	    first = clients[i].deadline;
+    if (first == 0)
+	return timeout;
+
+    unsigned long long now = getTimeUsec();
+    unsigned long long left = first > now? first - now: 0;
+
+    if (timeout != NULL &&
+	(unsigned long long)timeout->tv_sec * 1000000 + timeout->tv_usec <=
+	left)
+	return timeout;
+    tv->tv_sec = left / 1000000;
+    tv->tv_usec = left % 1000000;
+    return tv;
+}
+
+void metricsHandle(fd_set *readfds, bool iceIdle)
+{
+    if (metricsSocket < 0)
+	return;
+
+    unsigned long long now = getTimeUsec();
+    metricsClient *slot = NULL;
+
+    for (int i = 0; i < METRICS_MAX_CLIENTS; i++)
+    {
+	metricsClient &c = clients[i];
+
+	if (c.fd >= 0 && FD_ISSET(c.fd, readfds))
+	    readClient(c, iceIdle);
+	if (c.fd >= 0 && now >= c.deadline)
+	{
+	    debugOut("Metrics request timed out\n");
+	    closeClient(c);
+	}
+	if (c.fd < 0)
+	    slot = &c;
+    }
+
+    if (slot == NULL || !FD_ISSET(metricsSocket, readfds))
+	return;
+
+    int fd = accept(metricsSocket, NULL, NULL);
+    if (fd < 0)
+	return;
+    // Some systems pass O_NONBLOCK on from the listening socket.
+    fcntl(fd, F_SETFL, 0);
+    slot->fd = fd;
+    slot->deadline = now + METRICS_REQUEST_USEC;
+    slot->length = 0;
+    slot->request[0] = '\0';
+    // The request often follows the handshake within a moment.
+    readClient(*slot, iceIdle);
+}
+
+static int listenUnix(const char *path)
+{
+    struct sockaddr_un name;
+    int sock;
+
+    if (strlen(path) >= sizeof name.sun_path)
+    {
+	errno = ENAMETOOLONG;
+	return -1;
+    }
+    memset(&name, 0, sizeof name);
+    name.sun_family = AF_UNIX;
+    strcpy(name.sun_path, path);
+
+    sock = socket(PF_UNIX, SOCK_STREAM, 0);
+    if (sock < 0)
+	return -1;
+    // A socket left behind by a previous run would make bind() fail.
+    unlink(path);
+    if (bind(sock, (struct sockaddr *)&name, sizeof name) < 0)
+    {
+	close(sock);
+	return -1;
+    }
+    return sock;
+}
+
+static int listenTcp(const char *spec)
+{
+    struct sockaddr_in name;
+    char host[256];
+    const char *colon = strrchr(spec, ':');
+    const char *port = colon? colon + 1: spec;
+    char *endptr;
+    int sock, tmp;
+
+    if (colon != NULL && (size_t)(colon - spec) < sizeof host)
+    {
+	memcpy(host, spec, colon - spec);
+	host[colon - spec] = '\0';
+    }
+    else
+	strcpy(host, "127.0.0.1");
+
+    unsigned long portno = strtoul(port, &endptr, 10);
+    if (*port == '\0' || *endptr != '\0' || portno == 0 || portno > 65535)
+    {
+	errno = EINVAL;
+	return -1;
+    }
+
+    memset(&name, 0, sizeof name);
+    name.sin_family = AF_INET;
+    name.sin_port = htons(portno);
+    if (inet_aton(host, &name.sin_addr) == 0)
+    {
+	struct hostent *hostInfo = gethostbyname(host);
+
+	if (hostInfo == NULL)
+	{
+	    errno = EADDRNOTAVAIL;
+	    return -1;
+	}
+	name.sin_addr = *(struct in_addr *)hostInfo->h_addr;
+    }
+
+    sock = socket(PF_INET, SOCK_STREAM, 0);
+    if (sock < 0)
+	return -1;
+    tmp = 1;
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, (char *)&tmp, sizeof tmp);
+    if (bind(sock, (struct sockaddr *)&name, sizeof name) < 0)
+    {
+	close(sock);
+	return -1;
+    }
+    return sock;
+}
+
+bool metricsListen(const char *spec)
+{
+    int sock = strchr(spec, '/') != NULL? listenUnix(spec): listenTcp(spec);
+
+    if (sock < 0 || listen(sock, 4) < 0 ||
+	fcntl(sock, F_SETFL, O_NONBLOCK) < 0)
+    {
+	int err = errno;
+
+	if (sock >= 0)
+	    close(sock);
+	errno = err;
+	fprintf(stderr, "Cannot serve metrics on %s: %s\n", spec,
+		strerror(errno));
+	return false;
+    }
+
+    for (int i = 0; i < METRICS_MAX_CLIENTS; i++)
+	clients[i].fd = -1;
+    metricsSocket = sock;
+    metricsEnabled = traceActive = true;
+    return true;
+}
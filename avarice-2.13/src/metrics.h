@@ -0,0 +1,108 @@
+/*
+ *	avarice - The "avarice" program.
+ *
+ *	This program is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License Version 2
+ *	as published by the Free Software Foundation.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111, USA.
+ *
+ * Interface definition for the metrics endpoint (metrics.cc).
+ *
+ * The counters are served over HTTP in the Prometheus text exposition
+ * format.  ICE traffic is counted from the trace records (trace.h);
+ * the remaining counters are fed by the inline hooks below, which cost
+ * a single test of metricsEnabled when no endpoint has been set up.
+ */
+
+#ifndef INCLUDE_METRICS_H
+#define INCLUDE_METRICS_H
+
+#include <sys/select.h>
+
+#include "trace.h"
+
+enum
+{
+    // Minimal interval between reads of the ICE's own error counters.
+    METRICS_ICE_POLL_USEC	= 10000000,
+
+    // Scrapers that have connected but not yet sent their request.
+    METRICS_MAX_CLIENTS		= 4,
+
+    // Time a scraper gets to send its request head.
+    METRICS_REQUEST_USEC	= 2000000,
+};
+
+/** true once metricsListen() succeeded **/
+extern bool metricsEnabled;
+
+/** Serve metrics on 'spec', either "[<host>:]<port>" for TCP (host
+    defaults to 127.0.0.1), or the path of a Unix domain socket (any
+    spec containing a '/').
+
+    Returns false (after printing a diagnostic to stderr) if the socket
+    could not be set up.
+**/
+bool metricsListen(const char *spec);
+
+/** Count the ICE traffic described by trace record 'r'. **/
+void metricsRecord(const trace_record &r);
+
+void metricsCountMemory(unsigned long addr, unsigned int numBytes, bool write);
+void metricsCountCache(bool flash, bool hit);
+void metricsCountPacket(char type);
+
+/** Count a jtagRead() (or jtagWrite() if 'write') of 'numBytes' at
+    'addr', which still carries its address space offset.
+**/
+static inline void metricsMemory(unsigned long addr, unsigned int numBytes,
+				 bool write)
+{
+    if (metricsEnabled)
+	metricsCountMemory(addr, numBytes, write);
+}
+
+/** Count a lookup in the flash (or EEPROM) page cache. **/
+static inline void metricsCache(bool flash, bool hit)
+{
+    if (metricsEnabled)
+	metricsCountCache(flash, hit);
+}
+
+/** Count a gdb packet, by its first character. **/
+static inline void metricsPacket(char type)
+{
+    if (metricsEnabled)
+	metricsCountPacket(type);
+}
+
+/** Add the metrics socket, and the scrapers whose request has not
+    fully arrived yet, to 'readfds' for select(), raising 'maxfd' as
+    needed.
+**/
+void metricsAddFds(fd_set *readfds, int &maxfd);
+
+/** Return the select() timeout to use instead of 'timeout' (NULL to
+    wait forever) so that scrapers are dropped on time.  The result is
+    either 'timeout' or 'tv', which is filled in then.
+**/
+struct timeval *metricsTimeout(struct timeval *timeout, struct timeval *tv);
+
+/** Accept scrapers, read their requests and serve the complete ones,
+    as select() reported in 'readfds'; drop scrapers past their
+    deadline.
+    'iceIdle' says whether the ICE may be sent commands, i.e. the
+    target is stopped and no other command is under way; only then
+    are the ICE's error counters refreshed.
+**/
+void metricsHandle(fd_set *readfds, bool iceIdle);
+
+#endif /* INCLUDE_METRICS_H */
@@ -0,0 +1,314 @@
+/*
+ *	avarice - The "avarice" program.
+ *
+ *	This program is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License Version 2
+ *	as published by the Free Software Foundation.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111, USA.
+ *
+ * This file implements the commands available through GDB's "monitor"
+ * command (qRcmd packets).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "avarice.h"
+#include "jtag.h"
+#include "remote.h"
+#include "symbols.h"
+#include "sampler.h"
+#include "latency.h"
+#include "coredump.h"
+#include "memdiff.h"
+#include "trace.h"
+#include "monitor.h"
+
+enum
+{
+    MAX_MONITOR_ARGS = 16,
+
+    // Records shown by "monitor trace" without a count.
+    DEFAULT_TRACE_PRINT = 20,
+};
+
+struct monitor_cmd
+{
+    const char *name;
+    bool (*func)(int argc, char **argv);
+    const char *usage;
+};
+
+static bool cmdHelp(int argc, char **argv);
+static bool cmdSymbols(int argc, char **argv);
+static bool cmdSample(int argc, char **argv);
+static bool cmdLatency(int argc, char **argv);
+static bool cmdCore(int argc, char **argv);
+static bool cmdDiff(int argc, char **argv);
+static bool cmdTrace(int argc, char **argv);
+
+static const monitor_cmd monitorCommands[] =
+{
+    { "help",		cmdHelp,	"help" },
+    { "symbols",	cmdSymbols,	"symbols <elf-file>" },
+    { "sample",		cmdSample,
+      "sample <var>[:<size>][,...] [rate=<hz>] [count=<n>] "
+      "[file=<name>] [format=csv|binary]" },
+    { "latency",	cmdLatency,
+      "latency <start> <end> [count=<n>] [timer=<reg>[:<size>]] "
+      "[timer-hz=<hz>]" },
+    { "core",		cmdCore,	"core <file> [flash] [ram-end=<addr>]" },
+    { "diff",		cmdDiff,
+      "diff [on [ram-end=<addr>] [log=<file>]|off|now]" },
+    { "trace",		cmdTrace,	"trace [on|off|<count>|save <file>]" },
+    { 0, 0, 0 }
+};
+
+static bool cmdHelp(int, char **)
+{
+    gdbOut("AVaRICE monitor commands:\n");
+    for (const monitor_cmd *mc = monitorCommands; mc->name; mc++)
+	gdbOut("  %s\n", mc->usage);
+    return true;
+}
+
+static bool cmdSymbols(int argc, char **argv)
+{
+    if (argc != 2)
+    {
+	gdbOut("usage: symbols <elf-file>\n");
+	return false;
+    }
+    try
+    {
+	loadSymbols(argv[1]);
+    }
+    catch (jtag_exception&)
+    {
+	gdbOut("Cannot load symbols from %s\n", argv[1]);
+	return false;
+    }
+    gdbOut("Symbols loaded from %s\n", argv[1]);
+    return true;
+}
+
+static bool cmdSample(int argc, char **argv)
+{
+    double rate = DEFAULT_SAMPLE_RATE;
+    unsigned long count = 100;
+    const char *filename = NULL;
+    bool binary = false;
+
+    if (argc < 2)
+    {
+	gdbOut("usage: %s\n", monitorCommands[2].usage);
+	return false;
+    }
+    for (int i = 2; i < argc; i++)
+    {
+	if (strncmp(argv[i], "rate=", 5) == 0)
+	    rate = atof(argv[i] + 5);
+	else if (strncmp(argv[i], "count=", 6) == 0)
+	    count = strtoul(argv[i] + 6, NULL, 0);
+	else if (strncmp(argv[i], "file=", 5) == 0)
+	    filename = argv[i] + 5;
+	else if (strcmp(argv[i], "format=csv") == 0)
+	    binary = false;
+	else if (strcmp(argv[i], "format=binary") == 0)
+	    binary = true;
+	else
+	{
+	    gdbOut("Unknown sample option \"%s\"\n", argv[i]);
+	    return false;
+	}
+    }
+    if (!samplerSetVariables(argv[1]))
+    {
+	gdbOut("Cannot resolve \"%s\" (see avarice output)\n", argv[1]);
+	return false;
+    }
+
+    samplerRun(rate, count, filename, binary, true);
+    return true;
+}
+
+static bool cmdLatency(int argc, char **argv)
+{
+    unsigned long start, end, count = DEFAULT_LATENCY_COUNT;
+    unsigned long timerAddr = 0;
+    unsigned int timerSize = 0;
+    double timerHz = 0;
+
+    if (argc < 3)
+    {
+	gdbOut("usage: %s\n", monitorCommands[3].usage);
+	return false;
+    }
+    if (!parseCodeAddress(argv[1], start) || !parseCodeAddress(argv[2], end))
+    {
+	gdbOut("Cannot resolve code address (see avarice output)\n");
+	return false;
+    }
+    for (int i = 3; i < argc; i++)
+    {
+	if (strncmp(argv[i], "count=", 6) == 0)
+	    count = strtoul(argv[i] + 6, NULL, 0);
+	else if (strncmp(argv[i], "timer=", 6) == 0)
+	{
+	    if (!parseSymbolSpec(argv[i] + 6, timerAddr, timerSize))
+	    {
+		gdbOut("Cannot resolve \"%s\" (see avarice output)\n",
+		       argv[i] + 6);
+		return false;
+	    }
+	}
+	else if (strncmp(argv[i], "timer-hz=", 9) == 0)
+	    timerHz = atof(argv[i] + 9);
+	else
+	{
+	    gdbOut("Unknown latency option \"%s\"\n", argv[i]);
+	    return false;
+	}
+    }
+
+    latencyRun(start, end, count, timerAddr, timerSize, timerHz, true);
+    return true;
+}
+
+static bool cmdCore(int argc, char **argv)
+{
+    bool withFlash = false;
+    unsigned long ramEnd = 0;
+
+    if (argc < 2)
+    {
+	gdbOut("usage: %s\n", monitorCommands[4].usage);
+	return false;
+    }
+    for (int i = 2; i < argc; i++)
+    {
+	if (strcmp(argv[i], "flash") == 0)
+	    withFlash = true;
+	else if (strncmp(argv[i], "ram-end=", 8) == 0)
+	    ramEnd = strtoul(argv[i] + 8, NULL, 0);
+	else
+	{
+	    gdbOut("Unknown core option \"%s\"\n", argv[i]);
+	    return false;
+	}
+    }
+
+    return dumpCore(argv[1], withFlash, ramEnd, true);
+}
+
+static bool cmdDiff(int argc, char **argv)
+{
+    if (argc == 1)
+    {
+	memdiffReport(true);
+	return true;
+    }
+    if (strcmp(argv[1], "on") == 0)
+    {
+	unsigned long ramEnd = 0;
+	const char *logfile = NULL;
+
+	for (int i = 2; i < argc; i++)
+	{
+	    if (strncmp(argv[i], "ram-end=", 8) == 0)
+		ramEnd = strtoul(argv[i] + 8, NULL, 0);
+	    else if (strncmp(argv[i], "log=", 4) == 0)
+		logfile = argv[i] + 4;
+	    else
+	    {
+		gdbOut("Unknown diff option \"%s\"\n", argv[i]);
+		return false;
+	    }
+	}
+	return memdiffEnable(ramEnd, logfile, true);
+    }
+    if (strcmp(argv[1], "off") == 0 && argc == 2)
+    {
+	memdiffDisable();
+	return true;
+    }
+    if (strcmp(argv[1], "now") == 0 && argc == 2)
+    {
+	// e.g. after a stop not caused by "continue"
+	memdiffUpdate();
+	memdiffReport(true);
+	return true;
+    }
+
+    gdbOut("usage: %s\n", monitorCommands[5].usage);
+    return false;
+}
+
+static bool cmdTrace(int argc, char **argv)
+{
+    if (argc == 1)
+    {
+	tracePrint(gdbOut, DEFAULT_TRACE_PRINT);
+	return true;
+    }
+    if (argc == 2 && strcmp(argv[1], "on") == 0)
+    {
+	traceEnable(NULL);
+	return true;
+    }
+    if (argc == 2 && strcmp(argv[1], "off") == 0)
+    {
+	traceDisable();
+	return true;
+    }
+    if (argc == 3 && strcmp(argv[1], "save") == 0)
+    {
+	if (traceSave(argv[2]))
+	    return true;
+	gdbOut("Cannot write %s\n", argv[2]);
+	return false;
+    }
+    if (argc == 2)
+    {
+	char *endptr;
+	unsigned long count = strtoul(argv[1], &endptr, 0);
+
+	if (*endptr == '\0')
+	{
+	    tracePrint(gdbOut, count);
+	    return true;
+	}
+    }
+
+    gdbOut("usage: %s\n", monitorCommands[6].usage);
+    return false;
+}
+
+bool monitorCommand(char *cmd)
+{
+    char *argv[MAX_MONITOR_ARGS];
+    int argc = 0;
+
+    for (char *tok = strtok(cmd, " \t"); tok != NULL && argc < MAX_MONITOR_ARGS;
+	 tok = strtok(NULL, " \t"))
+	argv[argc++] = tok;
+
+    if (argc == 0)
+	return cmdHelp(argc, argv);
+
+    for (const monitor_cmd *mc = monitorCommands; mc->name; mc++)
+	if (strcmp(argv[0], mc->name) == 0)
+	    return mc->func(argc, argv);
+
+    gdbOut("Unknown monitor command \"%s\", try \"monitor help\"\n", argv[0]);
+    return false;
+}
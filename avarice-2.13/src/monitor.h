@@ -0,0 +1,32 @@
+/*
+ *	avarice - The "avarice" program.
+ *
+ *	This program is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License Version 2
+ *	as published by the Free Software Foundation.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111, USA.
+ *
+ * Interface definition for the GDB "monitor" command interpreter
+ * (monitor.cc).
+ */
+
+#ifndef INCLUDE_MONITOR_H
+#define INCLUDE_MONITOR_H
+
+/** Execute the (already hex-decoded) GDB "monitor" command 'cmd'.
+    'cmd' is modified while being tokenized.  Any output goes to the
+    GDB console.
+
+    Returns false if the command was unknown or failed.
+**/
+bool monitorCommand(char *cmd);
+
+#endif /* INCLUDE_MONITOR_H */
@@ -35,14 +35,14 @@
 #include "avarice.h"
 #include "remote.h"
 #include "jtag.h"
+#include "monitor.h"
+#include "memdiff.h"
+#include "hexcodec.h"
+#include "metrics.h"
+#include "console.h"
 
 enum
 {
-    /** BUFMAX defines the maximum number of characters in
-     * inbound/outbound buffers at least NUMREGBYTES*2 are needed for
-     * register packets
-     */
-    BUFMAX      = 400,
     NUMREGS     = 32/* + 1 + 1 + 1*/, /* SREG, FP, PC */
     SREG	= 32,
     SP		= 33,
@@ -60,9 +60,13 @@ static void error(int n);
 
 int gdbFileDescriptor = -1;
 
+// The last packet was 'D', which resumed the target.
+static bool gdbDetached;
+
 void setGdbFile(int fd)
 {
     gdbFileDescriptor = fd;
+    gdbDetached = false;
     int ret = fcntl(gdbFileDescriptor, F_SETFL, O_NONBLOCK);
     if (ret < 0)
         throw jtag_exception();
@@ -105,15 +109,25 @@ static void putDebugChar(char c)
 
 static void waitForGdbInput(void)
 {
-    int numfds;
+    int numfds, maxfd;
     fd_set readfds;
+    struct timeval tv;
 
-    FD_ZERO (&readfds);
-    FD_SET (gdbFileDescriptor, &readfds);
+    // Serve metrics scrapes while waiting.  The target is stopped
+    // here; while it runs, the jtagContinue() event loops wait instead.
+    do
+    {
+	FD_ZERO (&readfds);
+	FD_SET (gdbFileDescriptor, &readfds);
+	maxfd = gdbFileDescriptor;
+	metricsAddFds(&readfds, maxfd);
 
-    numfds = select (gdbFileDescriptor + 1, &readfds, 0, 0, 0);
-    if (numfds < 0)
-        throw jtag_exception();
+	numfds = select (maxfd + 1, &readfds, 0, 0, metricsTimeout(0, &tv));
+	if (numfds < 0)
+	    throw jtag_exception();
+	metricsHandle(&readfds, true);
+    }
+    while (!FD_ISSET(gdbFileDescriptor, &readfds));
 }
 
 /** Return single char read from gdb. Abort in case of problem,
@@ -123,12 +137,11 @@ int getDebugChar(void)
     uchar c = 0;
     int result;
 
-    do
-    {
+    // Only wait if nothing is pending: the event loops call us once
+    // select() reported input, and must not end up in
+    // waitForGdbInput() while the target runs.
+    while ((result = read(gdbFileDescriptor, &c, 1)) < 0 && errno == EAGAIN)
 	waitForGdbInput();
-	result = read(gdbFileDescriptor, &c, 1);
-    }
-    while (result < 0 && errno == EAGAIN);
 
     if (result < 0)
         throw jtag_exception();
@@ -136,8 +149,7 @@ int getDebugChar(void)
     if (result == 0) // gdb exited
     {
 	statusOut("gdb exited.\n");
-	theJtagICE->resumeProgram();
-        throw jtag_exception("gdb exited");
+        throw gdb_disconnect_exception(gdbDetached);
     }
 
     return (int)c;
@@ -159,8 +171,7 @@ int checkForDebugChar(void)
     if (result == 0) // gdb exited
     {
 	statusOut("gdb exited.\n");
-	theJtagICE->resumeProgram();
-        throw jtag_exception("gdb exited");
+        throw gdb_disconnect_exception(gdbDetached);
     }
 
     return (int)c;
@@ -226,33 +237,25 @@ static int hexToInt(char **ptr, int *intValue)
 **/
 static char *mem2hex(uchar *mem, char *buf, int count)
 {
-    for (int i = 0; i < count; i++)
-	buf = byteToHex(*mem++, buf);
+    hexEncode(mem, count, buf);
+    buf += 2 * count;
     *buf = 0;
 
     return (buf);
 }
 
 /** Convert the hex array pointed to by buf into binary to be placed in mem.
-    Return a pointer to the character AFTER the last byte written.
+    Return a pointer to the character AFTER the last byte written, or
+    NULL if buf contained anything but hex digits.
 **/
 static uchar *hex2mem(char *buf, uchar *mem, int count)
 {
-    int i;
-    unsigned char ch;
-
-    for(i = 0; i < count; i++)
-    {
-	ch = hex(*buf++) << 4;
-	ch = ch + hex(*buf++);
-	*mem++ = ch;
-    }
+    if (!hexDecode(buf, count, mem))
+	return NULL;
 
-    return (mem);
+    return (mem + count);
 }
 
-static void putpacket(char *buffer);
-
 void vgdbOut(const char *fmt, va_list args)
 {
     // We protect against reentry because putpacket could try and report
@@ -446,7 +449,7 @@ static bool singleStep()
     Return pointer to null-terminated, actual packet data (without $, #,
     the checksum)
 **/
-static char *getpacket(void)
+char *getpacket(void)
 {
     char *buffer = &remcomInBuffer[0];
     unsigned char checksum;
@@ -523,7 +526,7 @@ static char *getpacket(void)
 }
 
 /** Send packet 'buffer' to gdb. Adds $, # and checksum wrappers. **/
-static void putpacket(char *buffer)
+void putpacket(char *buffer)
 {
     unsigned char checksum;
     int count;
@@ -593,12 +596,14 @@ void talkToGdb(void)
     static char last_cmd = 0;
 
     ptr = getpacket();
+    metricsPacket(ptr[0]);
 
     debugOut("GDB: <%s>\n", ptr);
 
     // default empty response
     remcomOutBuffer[0] = 0;
 
+    gdbDetached = false;
     cmd = *ptr++;
     switch (cmd)
     {
@@ -664,8 +669,16 @@ void talkToGdb(void)
 
             last_orphan_pending = false;
 
+	    // The packet must hold exactly the announced number of
+	    // bytes of hex data.
+	    if ((int)strlen(ptr) != 2 * (length - lead))
+		break;
 	    jtagBuffer = new uchar[length];
-	    hex2mem(ptr, jtagBuffer+lead, length);
+	    if (hex2mem(ptr, jtagBuffer+lead, length - lead) == NULL)
+	    {
+		delete [] jtagBuffer;
+		break;
+	    }
             if (lead)
                 jtagBuffer[0] = last_orphan;
 
@@ -674,7 +687,7 @@ void talkToGdb(void)
                 // An odd length means we will have an orphan this round but
                 // only if we are writing to PROG space.
                 last_orphan_pending = true;
-                last_orphan = jtagBuffer[length];
+                last_orphan = jtagBuffer[length - 1];
                 length--;
             }
 
@@ -909,6 +922,27 @@ void talkToGdb(void)
                 }
             }
         }
+        else if (strncmp(ptr, "Rcmd,", 5) == 0)
+        {
+            // monitor command: hex-encoded command text
+            char cmdbuf[BUFMAX / 2];
+            int cmdlen = strlen(ptr + 5) / 2;
+
+            if (cmdlen >= (int)sizeof cmdbuf)
+                cmdlen = sizeof cmdbuf - 1;
+            if (hex2mem(ptr + 5, (uchar *)cmdbuf, cmdlen) == NULL)
+            {
+                error(1);
+                break;
+            }
+            cmdbuf[cmdlen] = '\0';
+            debugOut("\nGDB: monitor %s\n", cmdbuf);
+
+            if (monitorCommand(cmdbuf))
+                ok();
+            else
+                error(1);
+        }
 
         break;
     }
@@ -923,7 +957,8 @@ void talkToGdb(void)
             {
                 if (regno >= 0 && regno < NUMREGS)
                 {
-                    hex2mem(ptr, reg, 1);
+                    if (hex2mem(ptr, reg, 1) == NULL)
+                        break;
                     theJtagICE->jtagWrite(theJtagICE->cpuRegisterAreaAddress() + regno,
                                           1, reg);
                     ok();
@@ -931,20 +966,23 @@ void talkToGdb(void)
                 }
                 else if (regno == SREG)
                 {
-                    hex2mem(ptr, reg, 1);
+                    if (hex2mem(ptr, reg, 1) == NULL)
+                        break;
                     theJtagICE->jtagWrite(theJtagICE->statusAreaAddress() + 2,
 					  1, reg);
                 }
                 else if (regno == SP)
                 {
-                    hex2mem(ptr, reg, 2);
+                    if (hex2mem(ptr, reg, 2) == NULL)
+                        break;
                     theJtagICE->jtagWrite(theJtagICE->statusAreaAddress(),
                                           2, reg);
                     ok();
                 }
                 else if (regno == PC)
                 {
-                    hex2mem(ptr, reg, 4);
+                    if (hex2mem(ptr, reg, 4) == NULL)
+                        break;
                     theJtagICE->setProgramCounter(reg[0] | reg[1] << 8 |
                                                   reg[2] << 16 | reg[3] << 24);
                     ok();
@@ -978,6 +1016,8 @@ void talkToGdb(void)
             }
 	}
 	repStatus(singleStep());
+	memdiffUpdate();
+	consoleDrain();
 	break;
 
     case 'C':
@@ -1026,6 +1066,8 @@ void talkToGdb(void)
             }
 	}
 	repStatus(theJtagICE->jtagContinue());
+	memdiffUpdate();
+	consoleDrain();
 	break;
 
     case 'D':
@@ -1040,6 +1082,7 @@ void talkToGdb(void)
 	    error(1);
             break;
         }
+	gdbDetached = true;
         ok();
 	break;
 
@@ -22,6 +22,15 @@
 #ifndef INCLUDE_REMOTE_H
 #define INCLUDE_REMOTE_H
 
+enum
+{
+    /** BUFMAX defines the maximum number of characters in
+     * inbound/outbound buffers at least NUMREGBYTES*2 are needed for
+     * register packets
+     */
+    BUFMAX      = 400,
+};
+
 /** File descriptor for gdb communication. -1 before connection. **/
 extern int gdbFileDescriptor;
 
@@ -29,9 +38,25 @@ extern int gdbFileDescriptor;
 void setGdbFile(int fd);
 
 /** Return single char read from gdb. Abort in case of problem,
-    exit cleanly if EOF detected on gdbFileDescriptor. **/
+    throw gdb_disconnect_exception if EOF detected on
+    gdbFileDescriptor, flagged running if gdb detached with 'D'. **/
 int getDebugChar(void);
 
+/** Return single char read from gdb if one is available, -1 if none
+    is pending. Abort in case of problem, as getDebugChar() does. **/
+int checkForDebugChar(void);
+
+/** Read a packet from gdb, check its checksum, and acknowledge it.
+    Returns the NUL-terminated packet data (without $, # and the
+    checksum) in a static buffer.
+**/
+char *getpacket(void);
+
+/** Send packet 'buffer' to gdb, adding the $, # and checksum
+    wrappers, until gdb acknowledges it.
+**/
+void putpacket(char *buffer);
+
 /** printf 'fmt, ...' to gdb **/
 void gdbOut(const char *fmt, ...);
 void vgdbOut(const char *fmt, va_list args);
@@ -0,0 +1,325 @@
+/*
+ *	avarice - The "avarice" program.
+ *
+ *	This program is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License Version 2
+ *	as published by the Free Software Foundation.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111, USA.
+ *
+ * This file implements periodic sampling of target variables while
+ * the target keeps running.
+ *
+ * Neither the JTAG ICE mkI nor the mkII can read SRAM while the
+ * target is running, so each sample is a short stop/read/resume
+ * cycle.  To keep the target stopped as briefly as possible, all
+ * variables are fetched by a single memory read spanning them.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include "avarice.h"
+#include "jtag.h"
+#include "remote.h"
+#include "symbols.h"
+#include "sampler.h"
+
+struct sample_var
+{
+    char name[64];
+    unsigned long addr;
+    unsigned int size;
+};
+
+static sample_var sampleVars[MAX_SAMPLE_VARS];
+static unsigned int numSampleVars;
+
+static volatile sig_atomic_t samplingInterrupted;
+
+static void samplerSigint(int)
+{
+    samplingInterrupted = 1;
+}
+
+bool samplerSetVariables(const char *list)
+{
+    sample_var vars[MAX_SAMPLE_VARS];
+    unsigned int n = 0;
+    const char *cp1 = list, *cp2;
+
+    while (*cp1 != '\0')
+    {
+	char spec[128];
+
+	while (*cp1 == ',' || *cp1 == ' ')
+	    cp1++;
+	if (*cp1 == '\0')
+	    break;
+	cp2 = cp1;
+	while (*cp2 != '\0' && *cp2 != ',')
+	    cp2++;
+	size_t l = cp2 - cp1;
+
+	if (n == MAX_SAMPLE_VARS)
+	{
+	    fprintf(stderr, "Too many variables to sample (max. %d)\n",
+		    MAX_SAMPLE_VARS);
+	    return false;
+	}
+	if (l >= sizeof spec)
+	    l = sizeof spec - 1;
+	memcpy(spec, cp1, l);
+	spec[l] = '\0';
+
+	if (!parseSymbolSpec(spec, vars[n].addr, vars[n].size))
+	    return false;
+	if (vars[n].addr < DATA_SPACE_ADDR_OFFSET ||
+	    (vars[n].addr & ADDR_SPACE_MASK) != DATA_SPACE_ADDR_OFFSET)
+	{
+	    fprintf(stderr, "%s is not a data space address\n", spec);
+	    return false;
+	}
+
+	// The column name is the symbol part of the specification.
+	char *colon = strchr(spec, ':');
+	if (colon != NULL)
+	    *colon = '\0';
+	l = strlen(spec);
+	if (l >= sizeof vars[n].name)
+	{
+	    fprintf(stderr, "Variable name %s is too long\n", spec);
+	    return false;
+	}
+	memcpy(vars[n].name, spec, l);
+	vars[n].name[l] = '\0';
+	n++;
+
+	cp1 = cp2;
+    }
+
+    if (n == 0)
+    {
+	fprintf(stderr, "No variables to sample\n");
+	return false;
+    }
+
+    memcpy(sampleVars, vars, n * sizeof(sample_var));
+    numSampleVars = n;
+
+    return true;
+}
+
+/** Append the CSV representation of variable 'v' (taken from 'mem')
+    to 'buf'.  Up to 4 bytes are shown as (little-endian) unsigned
+    numbers, anything larger as a hex string.
+**/
+static char *formatValue(char *buf, const sample_var *v, const uchar *mem)
+{
+    if (v->size <= 4)
+    {
+	unsigned long val = 0;
+
+	for (unsigned int i = v->size; i-- > 0;)
+	    val = (val << 8) | mem[i];
+	buf += sprintf(buf, ",%lu", val);
+    }
+    else
+    {
+	*buf++ = ',';
+	for (unsigned int i = 0; i < v->size; i++)
+	    buf += sprintf(buf, "%02x", mem[i]);
+    }
+
+    return buf;
+}
+
+void samplerRun(double rate, unsigned long count, const char *filename,
+		bool binary, bool toGdb)
+{
+    void (*report)(const char *fmt, ...) = toGdb? gdbOut: statusOut;
+    FILE *out = NULL;
+
+    if (numSampleVars == 0)
+    {
+	report("No variables to sample.\n");
+	return;
+    }
+    if (rate <= 0)
+	rate = DEFAULT_SAMPLE_RATE;
+
+    if (filename != NULL)
+    {
+	if ((out = fopen(filename, binary? "wb": "w")) == NULL)
+	{
+	    report("Cannot open %s\n", filename);
+	    return;
+	}
+    }
+    else if (!toGdb)
+	out = stdout;
+    else if (binary)
+    {
+	report("Binary sampling output requires a file.\n");
+	return;
+    }
+
+    // Address range covered by a single read.
+    unsigned long lo = sampleVars[0].addr, hi = lo + sampleVars[0].size;
+    unsigned int linelen = 24;
+    for (unsigned int i = 1; i < numSampleVars; i++)
+    {
+	if (sampleVars[i].addr < lo)
+	    lo = sampleVars[i].addr;
+	if (sampleVars[i].addr + sampleVars[i].size > hi)
+	    hi = sampleVars[i].addr + sampleVars[i].size;
+    }
+    for (unsigned int i = 0; i < numSampleVars; i++)
+	linelen += 2 * sampleVars[i].size + strlen(sampleVars[i].name) + 12;
+    unsigned int span = hi - lo;
+
+    debugOut("Sampling %u variables, span 0x%lx..0x%lx (%u bytes)\n",
+	     numSampleVars, lo, hi, span);
+
+    char *line = new char[linelen];
+    if (!binary)
+    {
+	char *cp = line + sprintf(line, "time_us");
+	for (unsigned int i = 0; i < numSampleVars; i++)
+	    cp += sprintf(cp, ",%s", sampleVars[i].name);
+	if (out != NULL)
+	    fprintf(out, "%s\n", line);
+	else
+	    gdbOut("%s\n", line);
+    }
+
+    void (*oldsigint)(int) = SIG_DFL;
+    if (!toGdb)
+    {
+	samplingInterrupted = 0;
+	oldsigint = signal(SIGINT, samplerSigint);
+    }
+
+    unsigned long long interval = (unsigned long long)(1e6 / rate);
+    unsigned long long start = 0, next, halted = 0, maxHalt = 0;
+    unsigned long n = 0;
+    bool running = false, disconnected = false;
+
+    try
+    {
+	theJtagICE->resumeProgram();
+	running = true;
+
+	start = next = getTimeUsec();
+	while (count == 0 || n < count)
+	{
+	    if (samplingInterrupted)
+		break;
+	    if (toGdb && gdbFileDescriptor >= 0 && checkForDebugChar() == 3)
+		break;
+
+	    next += interval;
+	    unsigned long long now = getTimeUsec();
+	    if (next > now)
+		usleep(next - now);
+	    else if (now - next > interval)
+		// We fell behind by more than one period; don't try to
+		// catch up with a burst of samples.
+		next = now;
+
+	    unsigned long long t0 = getTimeUsec();
+	    theJtagICE->interruptProgram();
+	    running = false;
+	    unsigned long long stamp = getTimeUsec() - start;
+	    uchar *mem = theJtagICE->jtagRead(lo, span);
+	    if (mem == NULL)
+		throw jtag_exception("reading target memory failed");
+	    theJtagICE->resumeProgram();
+	    running = true;
+	    unsigned long long dt = getTimeUsec() - t0;
+
+	    halted += dt;
+	    if (dt > maxHalt)
+		maxHalt = dt;
+	    n++;
+
+	    if (binary)
+	    {
+		uchar ts[8];
+
+		for (int i = 0; i < 8; i++)
+		    ts[i] = (uchar)(stamp >> (8 * i));
+		fwrite(ts, 1, sizeof ts, out);
+		for (unsigned int i = 0; i < numSampleVars; i++)
+		    fwrite(mem + (sampleVars[i].addr - lo), 1,
+			   sampleVars[i].size, out);
+	    }
+	    else
+	    {
+		char *cp = line + sprintf(line, "%llu", stamp);
+		for (unsigned int i = 0; i < numSampleVars; i++)
+		    cp = formatValue(cp, &sampleVars[i],
+				     mem + (sampleVars[i].addr - lo));
+		if (out != NULL)
+		    fprintf(out, "%s\n", line);
+		else
+		    gdbOut("%s\n", line);
+	    }
+	    delete [] mem;
+	}
+
+	theJtagICE->interruptProgram();
+	running = false;
+    }
+    catch (gdb_disconnect_exception&)
+    {
+	// The server loop takes over, gdb is gone.
+	disconnected = true;
+    }
+    catch (jtag_exception& e)
+    {
+	report("Sampling aborted: %s\n", e.what());
+	if (running)
+	{
+	    try
+	    {
+		theJtagICE->interruptProgram();
+	    }
+	    catch (jtag_exception&)
+	    {
+		// nothing more we can do
+	    }
+	}
+    }
+
+    if (!toGdb)
+	signal(SIGINT, oldsigint);
+    if (out != NULL && out != stdout)
+	fclose(out);
+    else if (out != NULL)
+	fflush(out);
+    delete [] line;
+
+    if (disconnected)
+	throw gdb_disconnect_exception(running);
+    if (n == 0)
+	return;
+
+    unsigned long long elapsed = getTimeUsec() - start;
+    report("%lu samples in %.3f s: %.1f samples/s (requested %.1f)\n",
+	   n, elapsed / 1e6, n * 1e6 / elapsed, rate);
+    report("Target halted %.3f ms total (%.2f%%), %.0f us per sample, "
+	   "%llu us max\n",
+	   halted / 1e3, 100.0 * halted / elapsed, (double)halted / n,
+	   maxHalt);
+}
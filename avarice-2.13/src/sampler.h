@@ -0,0 +1,56 @@
+/*
+ *	avarice - The "avarice" program.
+ *
+ *	This program is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License Version 2
+ *	as published by the Free Software Foundation.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111, USA.
+ *
+ * Interface definition for the live variable sampler (sampler.cc).
+ */
+
+#ifndef INCLUDE_SAMPLER_H
+#define INCLUDE_SAMPLER_H
+
+enum
+{
+    MAX_SAMPLE_VARS		= 32,
+    DEFAULT_SAMPLE_RATE		= 100,	// samples per second
+};
+
+/** Set the list of variables to sample from a comma-separated list
+    of "<symbol>[:<size>]" specifications (see parseSymbolSpec()).
+
+    Returns false if any of the entries could not be resolved; the
+    previous list is kept then.
+**/
+bool samplerSetVariables(const char *list);
+
+/** Sample the variables at 'rate' samples per second, 'count' times
+    (0: until interrupted by SIGINT, or ^C in GDB).
+
+    The target must be stopped on entry, and is left stopped on
+    return.  Each sample briefly stops the target, fetches all
+    variables with a single memory read, and resumes it.
+
+    Samples are written to 'filename' (stdout, or the GDB console if
+    'toGdb', when NULL), either as CSV, or as a binary stream of
+    records consisting of an 8-byte little-endian timestamp (in
+    microseconds since the start of sampling), followed by the raw
+    bytes of all variables in the order they were listed.
+
+    Finally, the achieved sample rate and the time the target spent
+    stopped are reported.
+**/
+void samplerRun(double rate, unsigned long count, const char *filename,
+		bool binary, bool toGdb);
+
+#endif /* INCLUDE_SAMPLER_H */
@@ -0,0 +1,371 @@
+/*
+ *	avarice - The "avarice" program.
+ *
+ *	This program is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License Version 2
+ *	as published by the Free Software Foundation.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111, USA.
+ *
+ * This file implements a minimal reader for the symbol table of AVR
+ * ELF files.  It does not depend on libbfd, so symbol lookup remains
+ * available even if avarice has been configured without target
+ * programming support.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "avarice.h"
+#include "jtag.h"
+#include "elfdefs.h"
+#include "symbols.h"
+
+struct elf_symbol
+{
+    const char *name;
+    unsigned long value;
+    unsigned int size;
+};
+
+static char *symbolStrings;		// string table of the loaded file
+static elf_symbol *symbols;		// sorted by value
+static unsigned int numSymbols;
+
+static unsigned char *flashImage;	// flash contents of the loaded file
+static unsigned long flashImageSize;
+
+/** The memory space 'value' belongs to, in terms of the
+    xxx_SPACE_ADDR_OFFSET values.
+**/
+static unsigned long memorySpaceOf(unsigned long value)
+{
+    if (value < DATA_SPACE_ADDR_OFFSET)
+	return FLASH_SPACE_ADDR_OFFSET;
+    return value & ADDR_SPACE_MASK;
+}
+
+static int comparevalues(const void *a, const void *b)
+{
+    const elf_symbol *sa = (const elf_symbol *)a;
+    const elf_symbol *sb = (const elf_symbol *)b;
+
+    if (sa->value != sb->value)
+	return sa->value < sb->value? -1: 1;
+    // Sort labels before sized symbols at the same address, so
+    // symbolAt() finds the latter first.
+    return (int)sa->size - (int)sb->size;
+}
+
+static void unloadSymbols(void)
+{
+    delete [] symbols;
+    delete [] symbolStrings;
+    delete [] flashImage;
+    symbols = NULL;
+    symbolStrings = NULL;
+    numSymbols = 0;
+    flashImage = NULL;
+    flashImageSize = 0;
+}
+
+/** Collect the flash contents of the ELF file in 'image' (of length
+    'flen') from its loadable segments.  The load (physical) address
+    is used, so initialized data end up where they live in flash.
+**/
+static void loadFlashImage(const unsigned char *image, unsigned long flen)
+{
+    unsigned long phoff = elfU32(image + EH_PHOFF);
+    unsigned int phentsize = elfU16(image + EH_PHENTSIZE);
+    unsigned int phnum = elfU16(image + EH_PHNUM);
+    unsigned long size = 0;
+
+    if (phnum == 0 || phentsize < PH_SIZEOF ||
+	phoff + (unsigned long)phnum * phentsize > flen)
+	return;
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+	for (unsigned int i = 0; i < phnum; i++)
+	{
+	    const unsigned char *ph = image + phoff + i * phentsize;
+	    unsigned long offset = elfU32(ph + PH_OFFSET);
+	    unsigned long paddr = elfU32(ph + PH_PADDR);
+	    unsigned long filesz = elfU32(ph + PH_FILESZ);
+
+	    if (elfU32(ph + PH_TYPE) != PT_LOAD || filesz == 0 ||
+		paddr + filesz > DATA_SPACE_ADDR_OFFSET ||
+		offset + filesz > flen)
+		continue;
+	    if (pass == 0)
+	    {
+		// First pass: find the size.
+		if (paddr + filesz > size)
+		    size = paddr + filesz;
+	    }
+	    else
+		memcpy(flashImage + paddr, image + offset, filesz);
+	}
+	if (pass == 0)
+	{
+	    if (size == 0)
+		return;
+	    // Unused flash reads as erased.
+	    flashImage = new unsigned char[size];
+	    memset(flashImage, 0xff, size);
+	    flashImageSize = size;
+	}
+    }
+}
+
+void loadSymbols(const char *filename)
+{
+    FILE *f;
+    long flen;
+    unsigned char *image;
+
+    unloadSymbols();
+
+    if ((f = fopen(filename, "rb")) == NULL)
+    {
+	fprintf(stderr, "Cannot open ELF file %s\n", filename);
+	throw jtag_exception();
+    }
+    fseek(f, 0, SEEK_END);
+    flen = ftell(f);
+    rewind(f);
+    if (flen < EH_SIZE)
+    {
+	fclose(f);
+	fprintf(stderr, "%s: not an ELF file\n", filename);
+	throw jtag_exception();
+    }
+    image = new unsigned char[flen];
+    if (fread(image, 1, flen, f) != (size_t)flen)
+    {
+	fclose(f);
+	delete [] image;
+	fprintf(stderr, "%s: read error\n", filename);
+	throw jtag_exception();
+    }
+    fclose(f);
+
+    if (memcmp(image, "\177ELF", 4) != 0 ||
+	image[4] != ELFCLASS32 || image[5] != ELFDATA2LSB)
+    {
+	delete [] image;
+	fprintf(stderr, "%s: not a 32-bit little-endian ELF file\n", filename);
+	throw jtag_exception();
+    }
+
+    loadFlashImage(image, flen);
+
+    unsigned long shoff = elfU32(image + EH_SHOFF);
+    unsigned int shentsize = elfU16(image + EH_SHENTSIZE);
+    unsigned int shnum = elfU16(image + EH_SHNUM);
+
+    if (shentsize < SH_SIZEOF ||
+	shoff + (unsigned long)shnum * shentsize > (unsigned long)flen)
+    {
+	delete [] image;
+	fprintf(stderr, "%s: corrupt section header table\n", filename);
+	throw jtag_exception();
+    }
+
+    for (unsigned int i = 0; i < shnum; i++)
+    {
+	const unsigned char *sh = image + shoff + i * shentsize;
+
+	if (elfU32(sh + SH_TYPE) != SHT_SYMTAB)
+	    continue;
+
+	unsigned long symoff = elfU32(sh + SH_OFFSET);
+	unsigned long symsize = elfU32(sh + SH_SIZE);
+	unsigned int link = elfU32(sh + SH_LINK);
+	if (link >= shnum)
+	    break;
+	const unsigned char *strsh = image + shoff + link * shentsize;
+	unsigned long stroff = elfU32(strsh + SH_OFFSET);
+	unsigned long strsize = elfU32(strsh + SH_SIZE);
+
+	if (symoff + symsize > (unsigned long)flen ||
+	    stroff + strsize > (unsigned long)flen || strsize == 0)
+	    break;
+
+	// Keep a private, NUL-terminated copy of the string table so
+	// the symbol names can point into it.
+	symbolStrings = new char[strsize + 1];
+	memcpy(symbolStrings, image + stroff, strsize);
+	symbolStrings[strsize] = '\0';
+
+	unsigned int n = symsize / ST_SIZEOF;
+	symbols = new elf_symbol[n];
+	for (unsigned int j = 0; j < n; j++)
+	{
+	    const unsigned char *st = image + symoff + j * ST_SIZEOF;
+	    unsigned long nameoff = elfU32(st + ST_NAME);
+	    unsigned int type = st[ST_INFO] & 0x0f;
+	    unsigned int shndx = elfU16(st + ST_SHNDX);
+
+	    if (nameoff == 0 || nameoff >= strsize)
+		continue;
+	    if (type != STT_NOTYPE && type != STT_OBJECT && type != STT_FUNC)
+		continue;
+	    // Undefined and special (e.g. absolute) symbols are of no
+	    // use, with the exception of the linker-provided absolute
+	    // ones like __stack we look up by name.
+	    if (shndx == SHN_UNDEF)
+		continue;
+	    if (shndx >= SHN_LORESERVE && symbolStrings[nameoff] != '_')
+		continue;
+
+	    symbols[numSymbols].name = symbolStrings + nameoff;
+	    symbols[numSymbols].value = elfU32(st + ST_VALUE);
+	    symbols[numSymbols].size = elfU32(st + ST_SIZE);
+	    numSymbols++;
+	}
+	break;
+    }
+    delete [] image;
+
+    if (symbols == NULL)
+    {
+	fprintf(stderr, "%s: no symbol table found\n", filename);
+	throw jtag_exception();
+    }
+
+    qsort(symbols, numSymbols, sizeof(elf_symbol), comparevalues);
+
+    debugOut("Loaded %u symbols from %s\n", numSymbols, filename);
+}
+
+bool symbolsLoaded(void)
+{
+    return symbols != NULL;
+}
+
+const unsigned char *elfFlashImage(unsigned long &size)
+{
+    size = flashImageSize;
+    return flashImage;
+}
+
+bool lookupSymbol(const char *name, unsigned long &addr, unsigned int &size)
+{
+    for (unsigned int i = 0; i < numSymbols; i++)
+    {
+	if (strcmp(symbols[i].name, name) == 0)
+	{
+	    addr = symbols[i].value;
+	    size = symbols[i].size;
+	    return true;
+	}
+    }
+    return false;
+}
+
+const char *symbolAt(unsigned long addr, unsigned long &offset)
+{
+    unsigned int lo = 0, hi = numSymbols;
+
+    // Find the last symbol with value <= addr.
+    while (lo < hi)
+    {
+	unsigned int mid = (lo + hi) / 2;
+
+	if (symbols[mid].value <= addr)
+	    lo = mid + 1;
+	else
+	    hi = mid;
+    }
+
+    // Walk back over all candidates at or below 'addr'; a sized
+    // symbol at a lower address may still cover it.
+    for (unsigned int i = lo; i-- > 0;)
+    {
+	const elf_symbol *s = &symbols[i];
+
+	if (memorySpaceOf(s->value) != memorySpaceOf(addr))
+	    return NULL;
+	if (s->size != 0 && addr < s->value + s->size)
+	{
+	    offset = addr - s->value;
+	    return s->name;
+	}
+	// A label covers everything up to the next symbol, so it can
+	// only match if it is the closest one.
+	if (s->size == 0 && i + 1 == lo)
+	{
+	    offset = addr - s->value;
+	    return s->name;
+	}
+	if (addr - s->value > 0x10000)
+	    return NULL;
+    }
+    return NULL;
+}
+
+bool parseSymbolSpec(const char *spec, unsigned long &addr, unsigned int &size)
+{
+    char name[128];
+    const char *colon = strchr(spec, ':');
+    size_t len = colon? (size_t)(colon - spec): strlen(spec);
+    unsigned int symsize = 0;
+    char *endptr;
+
+    if (len == 0 || len >= sizeof name)
+    {
+	fprintf(stderr, "Invalid symbol specification \"%s\"\n", spec);
+	return false;
+    }
+    memcpy(name, spec, len);
+    name[len] = '\0';
+
+    if (isdigit((unsigned char)name[0]))
+    {
+	addr = strtoul(name, &endptr, 0);
+	if (*endptr != '\0')
+	{
+	    fprintf(stderr, "Invalid address \"%s\"\n", name);
+	    return false;
+	}
+    }
+    else if (!lookupSymbol(name, addr, symsize))
+    {
+	if (!symbolsLoaded())
+	    fprintf(stderr, "Cannot resolve \"%s\": no ELF file loaded\n",
+		    name);
+	else
+	    fprintf(stderr, "Symbol \"%s\" not found\n", name);
+	return false;
+    }
+
+    if (colon != NULL)
+    {
+	size = strtoul(colon + 1, &endptr, 0);
+	if (*endptr != '\0' || size == 0)
+	{
+	    fprintf(stderr, "Invalid size in \"%s\"\n", spec);
+	    return false;
+	}
+    }
+    else if (symsize != 0)
+	size = symsize;
+    else
+    {
+	fprintf(stderr, "Size of \"%s\" unknown, use %s:<size>\n",
+		name, name);
+	return false;
+    }
+
+    return true;
+}
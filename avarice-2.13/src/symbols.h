@@ -0,0 +1,69 @@
+/*
+ *	avarice - The "avarice" program.
+ *
+ *	This program is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License Version 2
+ *	as published by the Free Software Foundation.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111, USA.
+ *
+ * Interface definition for the ELF symbol table reader (symbols.cc).
+ * Besides the symbols, the flash contents of the ELF file are kept, to
+ * compare them against the target.
+ */
+
+#ifndef INCLUDE_SYMBOLS_H
+#define INCLUDE_SYMBOLS_H
+
+/** Read the symbol table and flash contents of the AVR ELF file
+    'filename'.  Any previously loaded file is discarded.
+
+    Symbol values are kept the way avr-gcc emits them, i.e. data
+    space symbols already carry DATA_SPACE_ADDR_OFFSET, and can
+    directly be passed to jtagRead()/jtagWrite().
+
+    Throws jtag_exception if the file cannot be read or is not a
+    32-bit little-endian ELF file.
+**/
+void loadSymbols(const char *filename);
+
+/** true iff a symbol table has been loaded **/
+bool symbolsLoaded(void);
+
+/** Return the flash contents of the ELF file loaded by loadSymbols()
+    (unused locations read as 0xff), and their size in 'size'.
+    Returns NULL if there is no ELF file, or it has no loadable flash
+    contents.
+**/
+const unsigned char *elfFlashImage(unsigned long &size);
+
+/** Look up symbol 'name'.  Returns true and fills in 'addr' and
+    'size' (0 if the ELF file did not record one) if found.
+**/
+bool lookupSymbol(const char *name, unsigned long &addr, unsigned int &size);
+
+/** Find the data or code symbol covering 'addr'.  Symbols without a
+    recorded size (typically assembler labels) cover everything up to
+    the next symbol in the same memory space.  Returns its name and
+    the offset of 'addr' into it, or NULL if there is none.
+**/
+const char *symbolAt(unsigned long addr, unsigned long &offset);
+
+/** Parse a "<symbol>[:<size>]" specification.  Instead of a symbol
+    name, a numeric (C notation) address may be given, in which case
+    the size is mandatory.  An explicit size overrides the size
+    recorded in the ELF file.
+
+    Returns false (after printing a diagnostic to stderr) if the
+    specification could not be resolved.
+**/
+bool parseSymbolSpec(const char *spec, unsigned long &addr, unsigned int &size);
+
+#endif /* INCLUDE_SYMBOLS_H */
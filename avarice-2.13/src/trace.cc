@@ -0,0 +1,275 @@
+/*
+ *	avarice - The "avarice" program.
+ *
+ *	This program is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License Version 2
+ *	as published by the Free Software Foundation.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111, USA.
+ *
+ * This file implements a binary trace of the communication with the
+ * JTAG ICE.  Unlike --debug output, records are kept in a fixed-size
+ * ring buffer in their raw form; they are only formatted when looked
+ * at, which is cheap enough to leave tracing on during normal use.
+ *
+ * Slots are claimed with an atomic increment, so records can be added
+ * from anywhere without locking, and the ring can be written out from
+ * a signal handler after a crash.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "avarice.h"
+#include "trace.h"
+#include "metrics.h"
+
+/** Trace files consist of this header, followed by 'count' records,
+    oldest first.
+**/
+struct trace_file_header
+{
+    char magic[4];		// TRACE_MAGIC
+    unsigned int recordSize;	// sizeof(trace_record)
+    unsigned int count;
+};
+
+static const char TRACE_MAGIC[4] = { 'A', 'V', 'T', 'R' };
+
+bool traceEnabled;
+bool traceActive;
+
+static trace_record traceRing[TRACE_RING_SIZE];
+// Number of records ever added; the next slot is traceNext modulo
+// TRACE_RING_SIZE.
+static volatile unsigned int traceNext;
+
+static char traceFile[1024];
+static bool traceHandlersInstalled;
+
+void traceRecord(const trace_record &r)
+{
+    if (metricsEnabled)
+	metricsRecord(r);
+    if (!traceEnabled)
+	return;
+
+    unsigned int i = __sync_fetch_and_add(&traceNext, 1);
+    trace_record &slot = traceRing[i & (TRACE_RING_SIZE - 1)];
+
+    slot = r;
+    slot.time = getTimeUsec();
+}
+
+/** The index of the oldest record, and the number of records. **/
+static unsigned int traceContents(unsigned int &count)
+{
+    unsigned int next = traceNext;
+
+    count = next < TRACE_RING_SIZE? next: (unsigned int)TRACE_RING_SIZE;
+    return (next - count) & (TRACE_RING_SIZE - 1);
+}
+
+/** Write all records to 'fd'.  Only uses async-signal-safe calls. **/
+static bool writeTrace(int fd)
+{
+    trace_file_header h;
+    unsigned int count, first = traceContents(count);
+    unsigned int n1 = count, n2 = 0;
+
+    memcpy(h.magic, TRACE_MAGIC, sizeof h.magic);
+    h.recordSize = sizeof(trace_record);
+    h.count = count;
+
+    if (first + count > TRACE_RING_SIZE)
+    {
+	n1 = TRACE_RING_SIZE - first;
+	n2 = count - n1;
+    }
+
+    return write(fd, &h, sizeof h) == (ssize_t)sizeof h &&
+	write(fd, traceRing + first, n1 * sizeof(trace_record)) ==
+	    (ssize_t)(n1 * sizeof(trace_record)) &&
+	write(fd, traceRing, n2 * sizeof(trace_record)) ==
+	    (ssize_t)(n2 * sizeof(trace_record));
+}
+
+bool traceSave(const char *filename)
+{
+    int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if (fd < 0)
+	return false;
+
+    bool ok = writeTrace(fd);
+    return close(fd) == 0 && ok;
+}
+
+static void traceAtExit(void)
+{
+    if (traceFile[0] != '\0' && !traceSave(traceFile))
+	fprintf(stderr, "Cannot write trace file %s\n", traceFile);
+}
+
+static void traceCrash(int sig)
+{
+    int fd = open(traceFile, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if (fd >= 0)
+    {
+	writeTrace(fd);
+	close(fd);
+    }
+    // The handler has been reset; die the way we would have.
+    raise(sig);
+}
+
+void traceEnable(const char *filename)
+{
+    if (filename != NULL)
+    {
+	strncpy(traceFile, filename, sizeof traceFile - 1);
+
+	if (!traceHandlersInstalled)
+	{
+	    static const int fatalSignals[] =
+		{ SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT };
+	    struct sigaction sa;
+
+	    memset(&sa, 0, sizeof sa);
+	    sa.sa_handler = traceCrash;
+	    sa.sa_flags = SA_RESETHAND;
+	    sigemptyset(&sa.sa_mask);
+	    for (unsigned int i = 0;
+		 i < sizeof fatalSignals / sizeof fatalSignals[0]; i++)
+		sigaction(fatalSignals[i], &sa, NULL);
+	    atexit(traceAtExit);
+	    traceHandlersInstalled = true;
+	}
+    }
+    traceEnabled = traceActive = true;
+}
+
+void traceDisable(void)
+{
+    traceEnabled = false;
+    traceActive = metricsEnabled;
+}
+
+/** Format record 'r' into 'buf', with times relative to 't0'. **/
+static void formatRecord(char *buf, size_t size, const trace_record *r,
+			 unsigned long long t0)
+{
+    double t = (long long)(r->time - t0) / 1e6;
+
+    switch (r->type)
+    {
+    case TRACE_FRAME_TX:
+	snprintf(buf, size, "%11.6f  tx       seq %5u  len %5u  cmd 0x%02x",
+		 t, r->seqno, r->length, r->cmd);
+	break;
+    case TRACE_FRAME_RX:
+	snprintf(buf, size, "%11.6f  rx       seq %5u  len %5u  rsp 0x%02x",
+		 t, r->seqno, r->length, r->cmd);
+	break;
+    case TRACE_COMMAND:
+	if (r->rsp == 0)
+	    snprintf(buf, size, "%11.6f  command  0x%02x: no response, "
+		     "%u us, try %u", t, r->cmd, r->latency, r->tries);
+	else
+	    snprintf(buf, size, "%11.6f  command  0x%02x: 0x%02x, "
+		     "%u us, try %u", t, r->cmd, r->rsp, r->latency, r->tries);
+	break;
+    case TRACE_TIMEOUT:
+	snprintf(buf, size, "%11.6f  timeout", t);
+	break;
+    case TRACE_CRC_ERROR:
+	snprintf(buf, size, "%11.6f  bad CRC  seq %5u  len %5u",
+		 t, r->seqno, r->length);
+	break;
+    case TRACE_EVENT:
+	snprintf(buf, size, "%11.6f  event    0x%02x", t, r->cmd);
+	break;
+    default:
+	snprintf(buf, size, "%11.6f  unknown record type %u", t, r->type);
+	break;
+    }
+}
+
+void tracePrint(void (*out)(const char *fmt, ...), unsigned int count)
+{
+    unsigned int n, first = traceContents(n);
+    char buf[128];
+
+    if (count != 0 && count < n)
+    {
+	first = (first + n - count) & (TRACE_RING_SIZE - 1);
+	n = count;
+    }
+    if (n == 0)
+    {
+	out("No trace records%s.\n",
+	    traceEnabled? "": " (tracing is off)");
+	return;
+    }
+
+    unsigned long long t0 = traceRing[first].time;
+    for (unsigned int i = 0; i < n; i++)
+    {
+	formatRecord(buf, sizeof buf,
+		     &traceRing[(first + i) & (TRACE_RING_SIZE - 1)], t0);
+	out("%s\n", buf);
+    }
+}
+
+bool traceDumpFile(const char *filename, FILE *f)
+{
+    FILE *in = fopen(filename, "rb");
+    trace_file_header h;
+    trace_record r;
+    unsigned long long t0 = 0;
+    char buf[128];
+
+    if (in == NULL)
+    {
+	fprintf(stderr, "Cannot open %s\n", filename);
+	return false;
+    }
+    if (fread(&h, sizeof h, 1, in) != 1 ||
+	memcmp(h.magic, TRACE_MAGIC, sizeof h.magic) != 0 ||
+	h.recordSize != sizeof(trace_record))
+    {
+	fprintf(stderr, "%s: not a trace file written by this avarice build\n",
+		filename);
+	fclose(in);
+	return false;
+    }
+
+    for (unsigned int i = 0; i < h.count; i++)
+    {
+	if (fread(&r, sizeof r, 1, in) != 1)
+	{
+	    fprintf(stderr, "%s: truncated after %u records\n", filename, i);
+	    fclose(in);
+	    return false;
+	}
+	if (i == 0)
+	    t0 = r.time;
+	formatRecord(buf, sizeof buf, &r, t0);
+	fprintf(f, "%s\n", buf);
+    }
+    fclose(in);
+
+    return true;
+}
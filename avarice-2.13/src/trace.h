@@ -0,0 +1,129 @@
+/*
+ *	avarice - The "avarice" program.
+ *
+ *	This program is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License Version 2
+ *	as published by the Free Software Foundation.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111, USA.
+ *
+ * Interface definition for the ICE communication trace (trace.cc).
+ */
+
+#ifndef INCLUDE_TRACE_H
+#define INCLUDE_TRACE_H
+
+#include <stdio.h>
+
+enum
+{
+    // Records kept; must be a power of two.
+    TRACE_RING_SIZE	= 8192,
+};
+
+enum trace_type
+{
+    TRACE_FRAME_TX = 1,		// frame sent to the ICE
+    TRACE_FRAME_RX,		// frame received from the ICE
+    TRACE_COMMAND,		// command completed (or failed)
+    TRACE_TIMEOUT,		// no (complete) response in time
+    TRACE_CRC_ERROR,		// frame dropped because of a bad CRC
+    TRACE_EVENT,		// asynchronous event from the ICE
+};
+
+/** One trace record.  Records are written to trace files as they are
+    kept in memory, so trace files are only portable between hosts of
+    the same byte order and word size.
+**/
+struct trace_record
+{
+    unsigned long long time;	// getTimeUsec()
+    unsigned char type;		// trace_type
+    unsigned char cmd;		// command, or first byte of the frame
+    unsigned char rsp;		// response code (TRACE_COMMAND)
+    unsigned char tries;	// attempt number (TRACE_COMMAND)
+    unsigned short seqno;	// mkII sequence number
+    unsigned int length;	// frame payload length
+    unsigned int latency;	// command round trip in us (TRACE_COMMAND)
+};
+
+/** true while records are being collected **/
+extern bool traceEnabled;
+
+/** true while records are collected, or fed to the metrics (see
+    metrics.h)
+**/
+extern bool traceActive;
+
+void traceRecord(const trace_record &r);
+
+/** Record frame related event 'type'.  Costs a single test of
+    traceActive when neither tracing nor metrics are on.
+**/
+static inline void traceFrame(trace_type type, unsigned int cmd,
+			      unsigned int seqno, unsigned int length)
+{
+    if (traceActive)
+    {
+	trace_record r;
+
+	r.type = type;
+	r.cmd = cmd;
+	r.rsp = r.tries = 0;
+	r.seqno = seqno;
+	r.length = length;
+	r.latency = 0;
+	traceRecord(r);
+    }
+}
+
+/** Record the outcome of sending command 'cmd': response code 'rsp'
+    (0 if none arrived) after 'latency' us, on attempt 'tries'.
+**/
+static inline void traceCommand(unsigned int cmd, unsigned int rsp,
+				unsigned int tries, unsigned long long latency)
+{
+    if (traceActive)
+    {
+	trace_record r;
+
+	r.type = TRACE_COMMAND;
+	r.cmd = cmd;
+	r.rsp = rsp;
+	r.tries = tries;
+	r.seqno = 0;
+	r.length = 0;
+	r.latency = latency;
+	traceRecord(r);
+    }
+}
+
+/** Start collecting records.  If 'filename' is not NULL, the records
+    are written to it when avarice exits, or crashes.
+**/
+void traceEnable(const char *filename);
+
+/** Stop collecting records; those collected so far are kept. **/
+void traceDisable(void);
+
+/** Write the collected records to 'filename'.  Returns false if the
+    file could not be written.
+**/
+bool traceSave(const char *filename);
+
+/** Print the last 'count' collected records (all if 0) using 'out'. **/
+void tracePrint(void (*out)(const char *fmt, ...), unsigned int count);
+
+/** Print the records in trace file 'filename' to 'f'.  Returns false
+    if it is not a valid trace file.
+**/
+bool traceDumpFile(const char *filename, FILE *f);
+
+#endif /* INCLUDE_TRACE_H */
@@ -23,6 +23,7 @@
 #include <errno.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/time.h>
 
 #include "avarice.h"
 #include "remote.h"
@@ -63,3 +64,10 @@ void statusFlush()
     fflush(stdout);
 }
 
+unsigned long long getTimeUsec(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return (unsigned long long)tv.tv_sec * 1000000ULL + tv.tv_usec;
+}
@@ -0,0 +1,105 @@
+/*
+ *	avarice - The "avarice" program.
+ *
+ *	This program is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License Version 2
+ *	as published by the Free Software Foundation.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111, USA.
+ *
+ * Target side of the avarice console (see --console), for avr-gcc.
+ *
+ * In exactly one source file:
+ *
+ *   #define AVARICE_CONSOLE_SIZE 64	// optional, default 64
+ *   #include "avarice_console.h"
+ *   AVARICE_CONSOLE_DEFINE();
+ *
+ * and include the header (with the same AVARICE_CONSOLE_SIZE) wherever
+ * avarice_console_putc() or avarice_console_write() are used.  With
+ * avr-libc's stdio, AVARICE_CONSOLE_STREAM(name) defines a FILE for
+ * printf() and friends:
+ *
+ *   AVARICE_CONSOLE_STREAM(console);
+ *   ...
+ *   stdout = &console;
+ *
+ * Output never blocks: when the buffer is full, it is dropped and
+ * counted, and avarice reports how much was lost.  Each byte costs
+ * some 20 cycles, with interrupts disabled for most of it.
+ */
+
+#ifndef AVARICE_CONSOLE_H
+#define AVARICE_CONSOLE_H
+
+#include <stdint.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#ifndef AVARICE_CONSOLE_SIZE
+#define AVARICE_CONSOLE_SIZE 64
+#endif
+
+#if AVARICE_CONSOLE_SIZE < 2 || AVARICE_CONSOLE_SIZE > 128 || \
+    (AVARICE_CONSOLE_SIZE & (AVARICE_CONSOLE_SIZE - 1)) != 0
+#error "AVARICE_CONSOLE_SIZE must be a power of two from 2 to 128"
+#endif
+
+/* The layout avarice expects, see src/console.h. */
+struct avarice_console
+{
+    uint8_t size;
+    volatile uint8_t head;	/* bytes written, modulo 256 */
+    volatile uint8_t tail;	/* bytes read by avarice, modulo 256 */
+    volatile uint8_t dropped;	/* bytes lost since avarice last looked */
+    char buf[AVARICE_CONSOLE_SIZE];
+};
+
+extern struct avarice_console __avarice_console;
+
+/* Initialized data, so the size is set up by the C startup code; the
+   debugger ignores the buffer until then. */
+#define AVARICE_CONSOLE_DEFINE()					\
+    struct avarice_console __avarice_console				\
+	__attribute__((used)) = { AVARICE_CONSOLE_SIZE, 0, 0, 0, { 0 } }
+
+static inline void avarice_console_putc(char c)
+{
+    struct avarice_console *con = &__avarice_console;
+    uint8_t sreg = SREG;
+
+    cli();
+    uint8_t head = con->head;
+    if ((uint8_t)(head - con->tail) < AVARICE_CONSOLE_SIZE)
+    {
+	con->buf[head & (AVARICE_CONSOLE_SIZE - 1)] = c;
+	con->head = head + 1;
+    }
+    else if (con->dropped != 0xff)
+	con->dropped++;
+    SREG = sreg;
+}
+
+static inline void avarice_console_write(const char *s, uint8_t len)
+{
+    while (len-- > 0)
+	avarice_console_putc(*s++);
+}
+
+#define AVARICE_CONSOLE_STREAM(name)					\
+    static int name##_put(char c, FILE *f)				\
+    {									\
+	(void)f;							\
+	avarice_console_putc(c);					\
+	return 0;							\
+    }									\
+    FILE name = FDEV_SETUP_STREAM(name##_put, NULL, _FDEV_SETUP_WRITE)
+
+#endif /* AVARICE_CONSOLE_H */